@@ -0,0 +1,152 @@
+-- Level 1: the jungle map with the player chopper and two enemies, the tank
+-- patrols through the "patrol" script.
+-- Loaded by LevelLoader; every entity's components are read once into a
+-- prefab, and an entity with a `positions` list is instantiated once per entry.
+Level = {
+    assets = {
+        { type = "texture", id = "tank-image", file = "./assets/images/tank-panther-right.png" },
+        { type = "texture", id = "truck-image", file = "./assets/images/truck-ford-right.png" },
+        { type = "texture", id = "chopper-image", file = "./assets/images/chopper-spritesheet.png" },
+        { type = "texture", id = "tilemap-image", file = "./assets/tilemaps/jungle.png" },
+        { type = "texture", id = "bullet-image", file = "./assets/images/bullet.png" },
+        { type = "font", id = "charriot-font", file = "./assets/fonts/charriot.ttf", font_size = 20 },
+        { type = "sound", id = "helicopter-sound", file = "./assets/sounds/helicopter.wav" }
+    },
+
+    -- Frames are spritesheet columns, playback is "loop", "once" or "ping_pong"
+    animation_clips = {
+        { name = "chopper-fly", frames = { 0, 1 }, frame_duration = 1 / 12, playback = "loop" }
+    },
+
+    -- Sound asset played by the AudioSystem for each gameplay event
+    event_sounds = {
+        projectile_fired = "helicopter-sound"
+    },
+
+    -- Each update runs once per frame over every entity using the script:
+    -- update(entity_ids, count, delta_time)
+    scripts = {
+        {
+            name = "patrol",
+            update = function(entity_ids, count, delta_time)
+                for i = 1, count do
+                    local id = entity_ids[i]
+                    local x, y = get_position(id)
+                    local velocity_x, velocity_y = get_velocity(id)
+                    if (x > 1000 and velocity_x > 0) or (x < 340 and velocity_x < 0) then
+                        set_velocity(id, -velocity_x, velocity_y)
+                    end
+                end
+            end
+        }
+    },
+
+    tilemap = {
+        map_file = "./assets/tilemaps/jungle.map",
+        texture_asset_id = "tilemap-image",
+        num_rows = 20,
+        num_cols = 25,
+        tile_size = 32,
+        scale = 3.0
+    },
+
+    entities = {
+        {
+            components = {
+                text_label = {
+                    position = { x = 10, y = 10 },
+                    text = "CHOPPER 1.0",
+                    font_asset_id = "charriot-font",
+                    color = { r = 0, g = 255, b = 0 },
+                    fixed = true
+                }
+            }
+        },
+        {
+            group = "enemies",
+            components = {
+                transform = { position = { x = 340, y = 10 }, scale = { x = 1, y = 1 }, rotation = 0 },
+                rigidbody = { velocity = { x = 30, y = 0 } },
+                sprite = { texture_asset_id = "tank-image", width = 32, height = 32, z_index = 1, fixed = true },
+                boxcollider = { width = 32, height = 32 },
+                health = { health_percentage = 100 },
+                camera_follow = {},
+                script = { name = "patrol" },
+                projectile_emitter = {
+                    projectile_velocity = { x = 100, y = 100 },
+                    repeat_frequency = 500,
+                    projectile_duration = 1000,
+                    hit_percentage_damage = 0,
+                    friendly = false,
+                    max_projectiles = 4
+                }
+            }
+        },
+        {
+            group = "enemies",
+            components = {
+                transform = { position = { x = 500, y = 10 }, scale = { x = 1, y = 1 }, rotation = 0 },
+                rigidbody = { velocity = { x = 0, y = 0 } },
+                sprite = { texture_asset_id = "truck-image", width = 32, height = 32, z_index = 2 },
+                boxcollider = { width = 32, height = 32 },
+                health = { health_percentage = 100 },
+                particle_emitter = {
+                    emission_rate = 40,
+                    burst_count = 12,
+                    particle_lifetime = 0.8,
+                    min_speed = 10,
+                    max_speed = 25,
+                    direction = 270,
+                    spread = 40,
+                    particle_size = 3,
+                    start_color = { r = 90, g = 90, b = 90, a = 160 },
+                    end_color = { r = 40, g = 40, b = 40, a = 0 },
+                    offset = { x = 4, y = 8 }
+                },
+                projectile_emitter = {
+                    projectile_velocity = { x = 100, y = 0 },
+                    repeat_frequency = 500,
+                    projectile_duration = 10000,
+                    hit_percentage_damage = 0,
+                    friendly = false,
+                    max_projectiles = 24
+                }
+            }
+        },
+        {
+            tag = "player",
+            components = {
+                transform = { position = { x = 10, y = 100 }, scale = { x = 1, y = 1 }, rotation = 0 },
+                rigidbody = { velocity = { x = 0, y = 0 } },
+                sprite = { texture_asset_id = "chopper-image", width = 32, height = 32, z_index = 3 },
+                animation = { clip = "chopper-fly" },
+                boxcollider = { width = 32, height = 32 },
+                camera_follow = {},
+                health = { health_percentage = 100 },
+                keyboard_controller = {
+                    up_velocity = { x = 0, y = -100 },
+                    right_velocity = { x = 100, y = 0 },
+                    down_velocity = { x = 0, y = 100 },
+                    left_velocity = { x = -100, y = 0 }
+                },
+                particle_emitter = {
+                    burst_count = 24,
+                    particle_lifetime = 0.25,
+                    min_speed = 40,
+                    max_speed = 120,
+                    particle_size = 2,
+                    start_color = { r = 255, g = 220, b = 120, a = 255 },
+                    end_color = { r = 255, g = 80, b = 0, a = 0 }
+                },
+                projectile_emitter = {
+                    projectile_velocity = { x = 150, y = 150 },
+                    repeat_frequency = 0,
+                    projectile_duration = 10000,
+                    hit_percentage_damage = 0,
+                    friendly = true,
+                    max_projectiles = 64
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#include <algorithm>
+
+#include "AnimationClips.h"
+#include "../Logger/Logger.h"
+
+std::vector<AnimationFrame> AnimationClips::m_frames;
+std::vector<AnimationClip> AnimationClips::m_clips;
+std::map<std::string, int> AnimationClips::m_clipIdPerName;
+
+int AnimationClips::AddClip(const std::string& name, const std::vector<AnimationFrame>& frames, AnimationPlayback playback) {
+	if (frames.empty()) {
+		Logger::Error("Animation clip " + name + " has no frames");
+		return -1;
+	}
+
+	// A zero duration would never advance, clamp it to a short frame
+	std::vector<AnimationFrame> clampedFrames;
+	clampedFrames.reserve(frames.size());
+	for (const auto& frame : frames) {
+		clampedFrames.push_back({ frame.column, std::max(frame.duration, 0.001f) });
+	}
+
+	const auto existingClip = m_clipIdPerName.find(name);
+	if (existingClip != m_clipIdPerName.end()) {
+		ReplaceFrames(existingClip->second, clampedFrames, playback);
+		return existingClip->second;
+	}
+
+	AnimationClip clip = { static_cast<int>(m_frames.size()), static_cast<int>(clampedFrames.size()), playback };
+	m_frames.insert(m_frames.end(), clampedFrames.begin(), clampedFrames.end());
+	m_clips.push_back(clip);
+	const int clipId = static_cast<int>(m_clips.size()) - 1;
+	m_clipIdPerName[name] = clipId;
+	return clipId;
+}
+
+// A clip that fits its old range is written in place, a longer one makes the
+// table be rebuilt without the old range so reloads do not grow it
+void AnimationClips::ReplaceFrames(int clipId, const std::vector<AnimationFrame>& frames, AnimationPlayback playback) {
+	AnimationClip& clip = m_clips[clipId];
+	const int numFrames = static_cast<int>(frames.size());
+
+	if (numFrames <= clip.numFrames) {
+		std::copy(frames.begin(), frames.end(), m_frames.begin() + clip.firstFrame);
+		clip.numFrames = numFrames;
+		clip.playback = playback;
+		return;
+	}
+
+	std::vector<AnimationFrame> compactedFrames;
+	compactedFrames.reserve(m_frames.size() - clip.numFrames + numFrames);
+	for (int otherClipId = 0; otherClipId < static_cast<int>(m_clips.size()); otherClipId++) {
+		AnimationClip& otherClip = m_clips[otherClipId];
+		if (otherClipId == clipId) continue;
+
+		const auto first = m_frames.begin() + otherClip.firstFrame;
+		otherClip.firstFrame = static_cast<int>(compactedFrames.size());
+		compactedFrames.insert(compactedFrames.end(), first, first + otherClip.numFrames);
+	}
+
+	clip = { static_cast<int>(compactedFrames.size()), numFrames, playback };
+	compactedFrames.insert(compactedFrames.end(), frames.begin(), frames.end());
+	m_frames = std::move(compactedFrames);
+}
+
+int AnimationClips::AddUniformClip(int numFrames, int framesPerSecond, AnimationPlayback playback) {
+	const std::string name = "uniform:" + std::to_string(numFrames) + ":" + std::to_string(framesPerSecond) + ":" + std::to_string(playback);
+	const int clipId = GetClipId(name);
+	if (clipId >= 0) return clipId;
+
+	std::vector<AnimationFrame> frames;
+	for (int column = 0; column < std::max(numFrames, 1); column++) {
+		frames.push_back({ column, 1.0f / std::max(framesPerSecond, 1) });
+	}
+	return AddClip(name, frames, playback);
+}
+
+int AnimationClips::GetClipId(const std::string& name) {
+	const auto clip = m_clipIdPerName.find(name);
+	return clip == m_clipIdPerName.end() ? -1 : clip->second;
+}
@@ -0,0 +1,53 @@
+#ifndef ANIMATIONCLIPS_H
+#define ANIMATIONCLIPS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+enum AnimationPlayback {
+	ANIMATION_LOOP,
+	ANIMATION_ONCE,
+	ANIMATION_PING_PONG
+};
+
+// One frame of a clip: the spritesheet column it shows and for how long
+struct AnimationFrame {
+	int column;
+	float duration;
+};
+
+struct AnimationClip {
+	int firstFrame;
+	int numFrames;
+	AnimationPlayback playback;
+};
+
+// Clip table shared by every animated entity, components only keep a clip
+// id. The frames of all the clips live in one contiguous array so the
+// animation update walks flat data. Clips are added on the main thread while
+// loading, the table is read-only while systems run.
+class AnimationClips {
+	private:
+		static std::vector<AnimationFrame> m_frames;
+		static std::vector<AnimationClip> m_clips;
+		static std::map<std::string, int> m_clipIdPerName;
+
+		static void ReplaceFrames(int clipId, const std::vector<AnimationFrame>& frames, AnimationPlayback playback);
+
+	public:
+		// Re-adding a name replaces the clip under the same id, AnimationSystem
+		// restarts entities whose frame is past the new clip's end
+		static int AddClip(const std::string& name, const std::vector<AnimationFrame>& frames, AnimationPlayback playback);
+		// Columns 0..numFrames-1 at framesPerSecond, shared by every caller
+		// asking for the same numbers
+		static int AddUniformClip(int numFrames, int framesPerSecond, AnimationPlayback playback);
+		// -1 when there is no such clip
+		static int GetClipId(const std::string& name);
+
+		static const AnimationClip& GetClip(int clipId) { return m_clips[clipId]; }
+		static int GetNumOfClips() { return static_cast<int>(m_clips.size()); }
+		static const std::vector<AnimationFrame>& GetFrames() { return m_frames; }
+};
+
+#endif
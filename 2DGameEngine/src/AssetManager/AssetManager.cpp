@@ -1,4 +1,6 @@
 #include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <algorithm>
 
 #include "../AssetManager/AssetManager.h"
 #include "../Logger/Logger.h"
@@ -18,6 +20,17 @@ void AssetManager::ClearAssets() {
 	}
 
 	m_textures.clear();
+	m_texturePaths.clear();
+
+	for (auto& font : m_fonts) {
+		SDL_DestroyTexture(font.second.texture);
+	}
+	m_fonts.clear();
+
+	for (auto& sound : m_sounds) {
+		Mix_FreeChunk(sound.second);
+	}
+	m_sounds.clear();
 }
 
 void AssetManager::AddTexture(const std::string& assetId, const std::string& filePath, SDL_Renderer* renderer) {
@@ -26,9 +39,147 @@ void AssetManager::AddTexture(const std::string& assetId, const std::string& fil
 	SDL_FreeSurface(surface);
 
 	m_textures.emplace(assetId, texture);
+	m_texturePaths.emplace(assetId, filePath);
 	Logger::Log("New asset added to the Asset Manager with id = " + assetId);
 }
 
 SDL_Texture* AssetManager::GetTexture(const std::string& assetId) {
 	return m_textures[assetId];
+}
+
+void AssetManager::AddFont(const std::string& assetId, const std::string& filePath, int fontSize, SDL_Renderer* renderer) {
+	TTF_Font* font = TTF_OpenFont(filePath.c_str(), fontSize);
+	if (!font) {
+		Logger::Error("Failed to open font " + filePath);
+		return;
+	}
+
+	FontAtlas atlas;
+	atlas.lineSkip = TTF_FontLineSkip(font);
+
+	// Lay the glyphs out in rows first, the atlas height is known afterwards
+	const SDL_Color white = { 255, 255, 255, 255 };
+	std::array<SDL_Surface*, FONT_LAST_GLYPH - FONT_FIRST_GLYPH + 1> glyphSurfaces = {};
+	int penX = 0;
+	int penY = 0;
+	int rowHeight = 0;
+	for (int character = FONT_FIRST_GLYPH; character <= FONT_LAST_GLYPH; character++) {
+		const int glyphIndex = character - FONT_FIRST_GLYPH;
+		Glyph& glyph = atlas.glyphs[glyphIndex];
+		glyph = { { 0, 0, 0, 0 }, 0 };
+
+		int minX, maxX, minY, maxY;
+		TTF_GlyphMetrics(font, static_cast<Uint16>(character), &minX, &maxX, &minY, &maxY, &glyph.advance);
+
+		SDL_Surface* surface = TTF_RenderGlyph_Blended(font, static_cast<Uint16>(character), white);
+		if (!surface) continue;
+
+		if (penX + surface->w > FONT_ATLAS_WIDTH) {
+			penX = 0;
+			penY += rowHeight;
+			rowHeight = 0;
+		}
+		glyph.srcRect = { penX, penY, surface->w, surface->h };
+		glyphSurfaces[glyphIndex] = surface;
+
+		penX += surface->w;
+		rowHeight = std::max(rowHeight, surface->h);
+	}
+	TTF_CloseFont(font);
+
+	atlas.width = FONT_ATLAS_WIDTH;
+	atlas.height = std::max(penY + rowHeight, 1);
+	SDL_Surface* atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, atlas.width, atlas.height, 32, SDL_PIXELFORMAT_RGBA32);
+	for (int glyphIndex = 0; glyphIndex < static_cast<int>(glyphSurfaces.size()); glyphIndex++) {
+		SDL_Surface* surface = glyphSurfaces[glyphIndex];
+		if (!surface) continue;
+
+		if (atlasSurface) {
+			// Copy the coverage as is instead of blending it onto the empty atlas
+			SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+			SDL_Rect destinationRectangle = atlas.glyphs[glyphIndex].srcRect;
+			SDL_BlitSurface(surface, NULL, atlasSurface, &destinationRectangle);
+		}
+		SDL_FreeSurface(surface);
+	}
+
+	if (!atlasSurface) {
+		Logger::Error("Failed to create the glyph atlas of font " + assetId);
+		return;
+	}
+	atlas.texture = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+	SDL_FreeSurface(atlasSurface);
+	SDL_SetTextureBlendMode(atlas.texture, SDL_BLENDMODE_BLEND);
+
+	const auto existingFont = m_fonts.find(assetId);
+	if (existingFont != m_fonts.end()) {
+		SDL_DestroyTexture(existingFont->second.texture);
+	}
+	m_fonts[assetId] = atlas;
+	Logger::Log("New font added to the Asset Manager with id = " + assetId);
+}
+
+const FontAtlas* AssetManager::GetFontAtlas(const std::string& assetId) const {
+	const auto font = m_fonts.find(assetId);
+	return font == m_fonts.end() ? nullptr : &font->second;
+}
+
+void AssetManager::AddSound(const std::string& assetId, const std::string& filePath) {
+	// Chunks are converted to the format of the open device
+	if (!Mix_QuerySpec(nullptr, nullptr, nullptr)) {
+		Logger::Warning("Audio is not open, sound " + assetId + " is not loaded");
+		return;
+	}
+
+	Mix_Chunk* sound = Mix_LoadWAV(filePath.c_str());
+	if (!sound) {
+		Logger::Error("Failed to load sound " + filePath);
+		return;
+	}
+
+	const auto existingSound = m_sounds.find(assetId);
+	if (existingSound != m_sounds.end()) {
+		Mix_FreeChunk(existingSound->second);
+	}
+	m_sounds[assetId] = sound;
+	Logger::Log("New sound added to the Asset Manager with id = " + assetId);
+}
+
+Mix_Chunk* AssetManager::GetSound(const std::string& assetId) const {
+	const auto sound = m_sounds.find(assetId);
+	return sound == m_sounds.end() ? nullptr : sound->second;
+}
+
+bool AssetManager::ReloadTexturesFromFile(const std::string& filePath, SDL_Renderer* renderer) {
+	bool isUsed = false;
+	for (const auto& texturePath : m_texturePaths) {
+		if (texturePath.second != filePath) continue;
+		isUsed = true;
+
+		SDL_Surface* surface = IMG_Load(filePath.c_str());
+		if (!surface) {
+			Logger::Error("Failed to reload texture " + texturePath.first + " from " + filePath);
+			continue;
+		}
+		SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+		SDL_FreeSurface(surface);
+		if (!texture) {
+			Logger::Error("Failed to reload texture " + texturePath.first + " from " + filePath);
+			continue;
+		}
+
+		SDL_Texture*& currentTexture = m_textures[texturePath.first];
+		SDL_DestroyTexture(currentTexture);
+		currentTexture = texture;
+		Logger::Info("Reloaded texture " + texturePath.first + " from " + filePath);
+	}
+	return isUsed;
+}
+
+std::vector<std::string> AssetManager::GetTextureFilePaths() const {
+	std::vector<std::string> filePaths;
+	for (const auto& texturePath : m_texturePaths) {
+		filePaths.push_back(texturePath.second);
+	}
+	return filePaths;
 }
\ No newline at end of file
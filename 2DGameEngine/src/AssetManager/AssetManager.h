@@ -1,14 +1,46 @@
 #ifndef ASSETMANAGER_H
 #define ASSETMANAGER_H
 
+#include <array>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "SDL.h"
+#include "SDL_mixer.h"
+
+// Printable ASCII range rasterized into every font's glyph atlas
+const int FONT_FIRST_GLYPH = 32;
+const int FONT_LAST_GLYPH = 126;
+const int FONT_ATLAS_WIDTH = 512;
+
+struct Glyph {
+	SDL_Rect srcRect;
+	int advance;
+};
+
+// All the glyphs of one font at one size packed into a single white texture,
+// text is drawn as quads sampling it and tinted per vertex
+struct FontAtlas {
+	SDL_Texture* texture = nullptr;
+	int width = 0;
+	int height = 0;
+	int lineSkip = 0;
+	std::array<Glyph, FONT_LAST_GLYPH - FONT_FIRST_GLYPH + 1> glyphs;
+
+	// nullptr for characters outside the atlas
+	const Glyph* GetGlyph(char character) const {
+		if (character < FONT_FIRST_GLYPH || character > FONT_LAST_GLYPH) return nullptr;
+		return &glyphs[character - FONT_FIRST_GLYPH];
+	}
+};
 
 class AssetManager {
 	private:
 		std::map<std::string, SDL_Texture*> m_textures;
+		std::map<std::string, std::string> m_texturePaths;
+		std::map<std::string, FontAtlas> m_fonts;
+		std::map<std::string, Mix_Chunk*> m_sounds;
 
 	public:
 		AssetManager();
@@ -17,6 +49,18 @@ class AssetManager {
 		void ClearAssets();
 		void AddTexture(const std::string& assetId, const std::string& filePath, SDL_Renderer* renderer);
 		SDL_Texture* GetTexture(const std::string& assetId);
+		// Rasterizes the font once into a glyph atlas, the font file is not kept open
+		void AddFont(const std::string& assetId, const std::string& filePath, int fontSize, SDL_Renderer* renderer);
+		const FontAtlas* GetFontAtlas(const std::string& assetId) const;
+		// Decoded once here into the mixer's format, playing never touches the file
+		void AddSound(const std::string& assetId, const std::string& filePath);
+		Mix_Chunk* GetSound(const std::string& assetId) const;
+
+		// Hot reload: replaces the textures loaded from filePath, keeping the old
+		// ones if the file cannot be loaded. Returns false when no texture uses it.
+		// Call between frames, sprites pick the new texture up on the next render.
+		bool ReloadTexturesFromFile(const std::string& filePath, SDL_Renderer* renderer);
+		std::vector<std::string> GetTextureFilePaths() const;
 };
 
 #endif
\ No newline at end of file
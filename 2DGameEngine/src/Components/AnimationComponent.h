@@ -1,21 +1,28 @@
 #ifndef ANIMATIONCOMPONENT_H
 #define ANIMATIONCOMPONENT_H
 
-#include <SDL.h>
-
+// Playback state of a clip from AnimationClips, advanced by the simulation
+// delta so it is paused, scaled and replayed with the game
 struct AnimationComponent {
-	int numFrames;
+	int clipId;
+	// Index within the clip, not the spritesheet column
 	int currentFrame;
-	int frameSpeedRate;
-	int startTime;
-	bool isLoop;
+	// +1 or -1, ping-pong clips flip it at either end
+	int direction;
+	// Seconds spent on the current frame
+	float frameTime;
+	// 0 pauses the animation
+	float timeScale;
+	// Set once a clip played once reaches its last frame
+	bool isFinished;
 
-	AnimationComponent(int numFrames = 1, int frameSpeedRate = 1, bool isLoop = true) {
-		this->numFrames = numFrames;
-		this->currentFrame = 1;
-		this->frameSpeedRate = frameSpeedRate;
-		this->startTime = SDL_GetTicks();
-		this->isLoop = isLoop;
+	AnimationComponent(int clipId = -1, float timeScale = 1.0f) {
+		this->clipId = clipId;
+		this->currentFrame = 0;
+		this->direction = 1;
+		this->frameTime = 0.0f;
+		this->timeScale = timeScale;
+		this->isFinished = false;
 	}
 };
 
@@ -0,0 +1,54 @@
+#ifndef PARTICLEEMITTERCOMPONENT_H
+#define PARTICLEEMITTERCOMPONENT_H
+
+#include <SDL.h>
+#include <glm/glm.hpp>
+
+struct ParticleEmitterComponent {
+	// Particles per second, 0 only emits bursts
+	float emissionRate;
+	// Particles spawned each time this entity fires a projectile
+	int burstCount;
+	// Seconds, each particle lives 75% to 125% of it
+	float particleLifetime;
+	float minSpeed;
+	float maxSpeed;
+	// Degrees, 0 points right and 90 down, particles spread around it
+	float direction;
+	float spread;
+	float particleSize;
+	SDL_Color startColor;
+	SDL_Color endColor;
+	// From the entity's position, bursts add it to the projectile's instead
+	glm::vec2 offset;
+	float emissionAccumulator;
+
+	ParticleEmitterComponent(
+		float emissionRate = 0.0f,
+		int burstCount = 0,
+		float particleLifetime = 1.0f,
+		float minSpeed = 10.0f,
+		float maxSpeed = 50.0f,
+		float direction = 0.0f,
+		float spread = 360.0f,
+		float particleSize = 2.0f,
+		SDL_Color startColor = { 255, 255, 255, 255 },
+		SDL_Color endColor = { 255, 255, 255, 0 },
+		glm::vec2 offset = glm::vec2(0)
+	) {
+		this->emissionRate = emissionRate;
+		this->burstCount = burstCount;
+		this->particleLifetime = particleLifetime;
+		this->minSpeed = minSpeed;
+		this->maxSpeed = maxSpeed;
+		this->direction = direction;
+		this->spread = spread;
+		this->particleSize = particleSize;
+		this->startColor = startColor;
+		this->endColor = endColor;
+		this->offset = offset;
+		this->emissionAccumulator = 0.0f;
+	}
+};
+
+#endif
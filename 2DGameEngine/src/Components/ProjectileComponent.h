@@ -7,13 +7,16 @@ struct ProjectileComponent {
     bool isFriendly;
     int hitPercentDamage;
     int duration;
-    int startTime;
+    double elapsedTime;
+    // Pooled projectiles are deactivated instead of killed when they expire
+    bool isPooled;
 
     ProjectileComponent(bool isFriendly = false, int hitPercentDamage = 0, int duration = 0) {
         this->isFriendly = isFriendly;
         this->hitPercentDamage = hitPercentDamage;
         this->duration = duration;
-        this->startTime = SDL_GetTicks();
+        this->elapsedTime = 0.0;
+        this->isPooled = false;
     }
 };
 
@@ -10,21 +10,25 @@ struct ProjectileEmitterComponent {
     int projectileDuration;
     int hitPercentDamage;
     bool isFriendly;
-    int lastEmissionTime;
+    double timeSinceLastEmission;
+    // Cap of the emitter's projectile pool, 0 creates and kills projectiles
+    int maxProjectiles;
 
     ProjectileEmitterComponent(
         glm::vec2 projectileVelocity = glm::vec2(0), 
         int repeatFrequency = 0, int 
         projectileDuration = 10000, 
         int hitPercentDamage = 10,
-        bool isFriendly = false
+        bool isFriendly = false,
+        int maxProjectiles = 0
     ) {
         this->projectileVelocity = projectileVelocity;
         this->repeatFrequency = repeatFrequency;
         this->projectileDuration = projectileDuration;
         this->hitPercentDamage = hitPercentDamage;
         this->isFriendly = isFriendly;
-        this->lastEmissionTime = SDL_GetTicks();
+        this->timeSinceLastEmission = 0.0;
+        this->maxProjectiles = maxProjectiles;
     }
 };
 
@@ -0,0 +1,13 @@
+#ifndef SCRIPTCOMPONENT_H
+#define SCRIPTCOMPONENT_H
+
+struct ScriptComponent {
+	// Index of the script in the ScriptSystem, -1 runs nothing
+	int scriptId;
+
+	ScriptComponent(int scriptId = -1) {
+		this->scriptId = scriptId;
+	}
+};
+
+#endif
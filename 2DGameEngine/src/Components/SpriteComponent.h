@@ -4,6 +4,8 @@
 #include <string>
 #include <SDL.h>
 
+#include "../ECS/Serialization.h"
+
 struct SpriteComponent {
 	std::string assetId;
 	int width;
@@ -33,6 +35,25 @@ struct SpriteComponent {
 			height
 		};
 	}
+
+	// Not trivially copyable, so snapshots go through these
+	void Serialize(std::ostream& stream) const {
+		WriteString(stream, assetId);
+		WriteValue(stream, width);
+		WriteValue(stream, height);
+		WriteValue(stream, zIndex);
+		WriteValue(stream, isFixed);
+		WriteValue(stream, srcRect);
+	}
+
+	void Deserialize(std::istream& stream) {
+		ReadString(stream, assetId);
+		ReadValue(stream, width);
+		ReadValue(stream, height);
+		ReadValue(stream, zIndex);
+		ReadValue(stream, isFixed);
+		ReadValue(stream, srcRect);
+	}
 };
 
 #endif
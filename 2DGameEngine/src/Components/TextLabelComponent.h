@@ -0,0 +1,49 @@
+#ifndef TEXTLABELCOMPONENT_H
+#define TEXTLABELCOMPONENT_H
+
+#include <string>
+#include <SDL.h>
+#include <glm/glm.hpp>
+
+#include "../ECS/Serialization.h"
+
+struct TextLabelComponent {
+	glm::vec2 position;
+	std::string text;
+	std::string assetId;
+	SDL_Color color;
+	bool isFixed;
+
+	TextLabelComponent(
+		glm::vec2 position = glm::vec2(0),
+		std::string text = "",
+		std::string assetId = "",
+		SDL_Color color = { 255, 255, 255, 255 },
+		bool isFixed = true
+	) {
+		this->position = position;
+		this->text = text;
+		this->assetId = assetId;
+		this->color = color;
+		this->isFixed = isFixed;
+	}
+
+	// Not trivially copyable, so snapshots go through these
+	void Serialize(std::ostream& stream) const {
+		WriteValue(stream, position);
+		WriteString(stream, text);
+		WriteString(stream, assetId);
+		WriteValue(stream, color);
+		WriteValue(stream, isFixed);
+	}
+
+	void Deserialize(std::istream& stream) {
+		ReadValue(stream, position);
+		ReadString(stream, text);
+		ReadString(stream, assetId);
+		ReadValue(stream, color);
+		ReadValue(stream, isFixed);
+	}
+};
+
+#endif
@@ -3,13 +3,17 @@
 
 #include <glm/glm.hpp>
 
+// previousPosition is the position before the last simulation step, the
+// renderers interpolate between the two.
 struct TransformComponent {
 	glm::vec2 position;
+	glm::vec2 previousPosition;
 	glm::vec2 scale;
 	double rotation;
 
 	TransformComponent(const glm::vec2& position = glm::vec2(0, 0), const glm::vec2& scale = glm::vec2(1, 1), double rotation = 0.0) {
 		this->position = position;
+		this->previousPosition = position;
 		this->scale = scale;
 		this->rotation = rotation;
 	}
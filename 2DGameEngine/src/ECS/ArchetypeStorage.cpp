@@ -0,0 +1,156 @@
+#include <algorithm>
+
+#include "ArchetypeStorage.h"
+
+ArchetypeStorage::~ArchetypeStorage() {
+	for (const auto& archetype : m_archetypes) {
+		for (unsigned int chunkIndex = 0; chunkIndex < archetype->chunks.size(); chunkIndex++) {
+			for (unsigned int row = 0; row < archetype->chunks[chunkIndex]->GetCount(); row++) {
+				for (size_t column = 0; column < archetype->componentIds.size(); column++) {
+					m_componentTypes[archetype->componentIds[column]].destroy(archetype->GetComponent(chunkIndex, row, static_cast<int>(column)));
+				}
+			}
+		}
+	}
+}
+
+EntityLocation& ArchetypeStorage::GetLocation(int entityId) {
+	if (entityId >= static_cast<int>(m_entityLocations.size())) {
+		m_entityLocations.resize(entityId + 1);
+	}
+	return m_entityLocations[entityId];
+}
+
+int ArchetypeStorage::GetOrCreateArchetype(const Signature& signature) {
+	auto existing = m_archetypePerSignature.find(signature);
+	if (existing != m_archetypePerSignature.end()) {
+		return existing->second;
+	}
+
+	auto archetype = std::make_unique<Archetype>();
+	archetype->signature = signature;
+	archetype->columnPerComponent.fill(-1);
+
+	size_t rowBytes = 0;
+	for (unsigned int componentId = 0; componentId < MAX_COMPONENTS; componentId++) {
+		if (!signature.test(componentId)) continue;
+
+		archetype->columnPerComponent[componentId] = static_cast<int>(archetype->componentIds.size());
+		archetype->componentIds.push_back(componentId);
+		archetype->columnSizes.push_back(m_componentTypes[componentId].size);
+		rowBytes += m_componentTypes[componentId].size;
+	}
+
+	archetype->chunkCapacity = std::max<unsigned int>(1, static_cast<unsigned int>(ARCHETYPE_CHUNK_BYTES / rowBytes));
+
+	size_t offset = 0;
+	for (int componentId : archetype->componentIds) {
+		const size_t alignment = m_componentTypes[componentId].alignment;
+		offset = (offset + alignment - 1) / alignment * alignment;
+		archetype->columnOffsets.push_back(offset);
+		offset += m_componentTypes[componentId].size * archetype->chunkCapacity;
+	}
+	archetype->chunkBytes = offset;
+
+	m_archetypes.push_back(std::move(archetype));
+	const int archetypeIndex = static_cast<int>(m_archetypes.size() - 1);
+	m_archetypePerSignature.emplace(signature, archetypeIndex);
+	return archetypeIndex;
+}
+
+EntityLocation ArchetypeStorage::AllocateRow(int archetypeIndex, int entityId) {
+	auto& archetype = *m_archetypes[archetypeIndex];
+
+	if (archetype.chunks.empty() || archetype.chunks.back()->GetCount() == archetype.chunkCapacity) {
+		auto chunk = std::make_unique<ArchetypeChunk>();
+		chunk->data.reset(new unsigned char[archetype.chunkBytes]);
+		chunk->entityIds.reserve(archetype.chunkCapacity);
+		archetype.chunks.push_back(std::move(chunk));
+	}
+
+	auto& chunk = *archetype.chunks.back();
+	EntityLocation location;
+	location.archetype = archetypeIndex;
+	location.chunk = static_cast<unsigned int>(archetype.chunks.size() - 1);
+	location.row = chunk.GetCount();
+	chunk.entityIds.push_back(entityId);
+	return location;
+}
+
+// Expects the components of the row to be destroyed (or moved from) already
+void ArchetypeStorage::RemoveRow(const EntityLocation& location) {
+	auto& archetype = *m_archetypes[location.archetype];
+	const unsigned int lastChunkIndex = static_cast<unsigned int>(archetype.chunks.size() - 1);
+	auto& lastChunk = *archetype.chunks[lastChunkIndex];
+	const unsigned int lastRow = lastChunk.GetCount() - 1;
+
+	if (location.chunk != lastChunkIndex || location.row != lastRow) {
+		for (size_t column = 0; column < archetype.componentIds.size(); column++) {
+			const auto& info = m_componentTypes[archetype.componentIds[column]];
+			void* last = archetype.GetComponent(lastChunkIndex, lastRow, static_cast<int>(column));
+			info.moveConstruct(archetype.GetComponent(location.chunk, location.row, static_cast<int>(column)), last);
+			info.destroy(last);
+		}
+
+		const int movedEntityId = lastChunk.entityIds[lastRow];
+		archetype.chunks[location.chunk]->entityIds[location.row] = movedEntityId;
+		m_entityLocations[movedEntityId] = location;
+	}
+
+	lastChunk.entityIds.pop_back();
+	if (lastChunk.entityIds.empty()) {
+		archetype.chunks.pop_back();
+	}
+}
+
+EntityLocation ArchetypeStorage::ChangeArchetype(int entityId, const Signature& signature) {
+	const EntityLocation oldLocation = GetLocation(entityId);
+
+	EntityLocation newLocation;
+	if (signature.any()) {
+		newLocation = AllocateRow(GetOrCreateArchetype(signature), entityId);
+	}
+
+	if (oldLocation.archetype != -1) {
+		const auto& oldArchetype = *m_archetypes[oldLocation.archetype];
+
+		for (size_t column = 0; column < oldArchetype.componentIds.size(); column++) {
+			const int componentId = oldArchetype.componentIds[column];
+			const auto& info = m_componentTypes[componentId];
+			void* source = oldArchetype.GetComponent(oldLocation.chunk, oldLocation.row, static_cast<int>(column));
+
+			if (signature.test(componentId)) {
+				const auto& newArchetype = *m_archetypes[newLocation.archetype];
+				info.moveConstruct(newArchetype.GetComponent(newLocation.chunk, newLocation.row, newArchetype.columnPerComponent[componentId]), source);
+			}
+			info.destroy(source);
+		}
+
+		RemoveRow(oldLocation);
+	}
+
+	m_entityLocations[entityId] = newLocation;
+	return newLocation;
+}
+
+void ArchetypeStorage::RemoveComponent(int entityId, int componentId) {
+	const EntityLocation location = GetLocation(entityId);
+	if (location.archetype == -1) return;
+
+	Signature signature = m_archetypes[location.archetype]->signature;
+	if (!signature.test(componentId)) return;
+
+	signature.reset(componentId);
+	ChangeArchetype(entityId, signature);
+}
+
+void ArchetypeStorage::AddEntity(int entityId, const Signature& signature) {
+	ChangeArchetype(entityId, signature);
+}
+
+void ArchetypeStorage::RemoveEntity(int entityId) {
+	const EntityLocation location = GetLocation(entityId);
+	if (location.archetype == -1) return;
+
+	ChangeArchetype(entityId, Signature());
+}
@@ -0,0 +1,163 @@
+#ifndef ARCHETYPESTORAGE_H
+#define ARCHETYPESTORAGE_H
+
+#include <array>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Signature.h"
+
+// Bytes of component data per chunk, rows per chunk follow from the row size
+const unsigned int ARCHETYPE_CHUNK_BYTES = 16 * 1024;
+
+struct ComponentTypeInfo {
+	size_t size = 0;
+	size_t alignment = 0;
+	void (*moveConstruct)(void* destination, void* source) = nullptr;
+	void (*destroy)(void* object) = nullptr;
+};
+
+// A chunk stores `capacity` rows as one array per component (SoA)
+struct ArchetypeChunk {
+	std::unique_ptr<unsigned char[]> data;
+	std::vector<int> entityIds;
+
+	unsigned int GetCount() const { return static_cast<unsigned int>(entityIds.size()); }
+};
+
+struct Archetype {
+	Signature signature;
+	std::vector<int> componentIds;
+	std::array<int, MAX_COMPONENTS> columnPerComponent;
+	std::vector<size_t> columnOffsets;
+	std::vector<size_t> columnSizes;
+	size_t chunkBytes;
+	unsigned int chunkCapacity;
+	std::vector<std::unique_ptr<ArchetypeChunk>> chunks;
+
+	void* GetComponent(unsigned int chunkIndex, unsigned int row, int column) const {
+		return chunks[chunkIndex]->data.get() + columnOffsets[column] + row * columnSizes[column];
+	}
+
+	template <typename T> T* GetColumn(const ArchetypeChunk& chunk, int componentId) const {
+		return reinterpret_cast<T*>(chunk.data.get() + columnOffsets[columnPerComponent[componentId]]);
+	}
+};
+
+struct EntityLocation {
+	int archetype = -1;
+	unsigned int chunk = 0;
+	unsigned int row = 0;
+};
+
+// Component storage where entities with the same signature share tables.
+// Adding or removing a component moves the entity to another archetype, and
+// removing a row moves the last row of that archetype into the hole, so a
+// component reference is only valid until the next structural change to the
+// entity or to its archetype.
+class ArchetypeStorage {
+	private:
+		std::vector<ComponentTypeInfo> m_componentTypes;
+		std::vector<std::unique_ptr<Archetype>> m_archetypes;
+		std::unordered_map<Signature, int> m_archetypePerSignature;
+		std::vector<EntityLocation> m_entityLocations;
+
+		int GetOrCreateArchetype(const Signature& signature);
+		EntityLocation AllocateRow(int archetypeIndex, int entityId);
+		void RemoveRow(const EntityLocation& location);
+		EntityLocation ChangeArchetype(int entityId, const Signature& signature);
+		EntityLocation& GetLocation(int entityId);
+
+	public:
+		ArchetypeStorage() = default;
+		~ArchetypeStorage();
+
+		ArchetypeStorage(const ArchetypeStorage&) = delete;
+		ArchetypeStorage& operator =(const ArchetypeStorage&) = delete;
+
+		template <typename T> void RegisterComponentType(int componentId);
+		template <typename T> void AddComponent(int entityId, int componentId, T&& component);
+		void RemoveComponent(int entityId, int componentId);
+
+		// Places a new entity in the archetype of `signature` without
+		// constructing its components, ConstructComponent must follow for each
+		void AddEntity(int entityId, const Signature& signature);
+		template <typename T> void ConstructComponent(int entityId, int componentId, const T& component);
+		void RemoveEntity(int entityId);
+
+		template <typename T> T& GetComponent(int entityId, int componentId) const;
+
+		// Calls func(chunk, archetype) for every chunk whose signature contains `signature`
+		template <typename TFunc> void ForEachChunk(const Signature& signature, TFunc func) const;
+
+		size_t GetNumOfArchetypes() const { return m_archetypes.size(); }
+};
+
+template <typename T>
+void ArchetypeStorage::RegisterComponentType(int componentId) {
+	if (componentId >= static_cast<int>(m_componentTypes.size())) {
+		m_componentTypes.resize(componentId + 1);
+	}
+
+	auto& info = m_componentTypes[componentId];
+	if (info.size != 0) return;
+
+	info.size = sizeof(T);
+	info.alignment = alignof(T);
+	info.moveConstruct = [](void* destination, void* source) { new (destination) T(std::move(*static_cast<T*>(source))); };
+	info.destroy = [](void* object) { static_cast<T*>(object)->~T(); };
+}
+
+template <typename T>
+void ArchetypeStorage::AddComponent(int entityId, int componentId, T&& component) {
+	typedef typename std::decay<T>::type TComponent;
+
+	RegisterComponentType<TComponent>(componentId);
+
+	EntityLocation location = GetLocation(entityId);
+	Signature signature;
+	if (location.archetype != -1) {
+		const auto& archetype = *m_archetypes[location.archetype];
+		if (archetype.signature.test(componentId)) {
+			*static_cast<TComponent*>(archetype.GetComponent(location.chunk, location.row, archetype.columnPerComponent[componentId])) = std::forward<T>(component);
+			return;
+		}
+		signature = archetype.signature;
+	}
+
+	signature.set(componentId);
+	location = ChangeArchetype(entityId, signature);
+
+	const auto& archetype = *m_archetypes[location.archetype];
+	new (archetype.GetComponent(location.chunk, location.row, archetype.columnPerComponent[componentId])) TComponent(std::forward<T>(component));
+}
+
+template <typename T>
+void ArchetypeStorage::ConstructComponent(int entityId, int componentId, const T& component) {
+	const EntityLocation& location = m_entityLocations[entityId];
+	const auto& archetype = *m_archetypes[location.archetype];
+	new (archetype.GetComponent(location.chunk, location.row, archetype.columnPerComponent[componentId])) T(component);
+}
+
+template <typename T>
+T& ArchetypeStorage::GetComponent(int entityId, int componentId) const {
+	const EntityLocation& location = m_entityLocations[entityId];
+	const auto& archetype = *m_archetypes[location.archetype];
+	return *static_cast<T*>(archetype.GetComponent(location.chunk, location.row, archetype.columnPerComponent[componentId]));
+}
+
+template <typename TFunc>
+void ArchetypeStorage::ForEachChunk(const Signature& signature, TFunc func) const {
+	for (const auto& archetype : m_archetypes) {
+		if ((archetype->signature & signature) != signature) continue;
+
+		for (const auto& chunk : archetype->chunks) {
+			func(*chunk, *archetype);
+		}
+	}
+}
+
+#endif
@@ -1,17 +1,24 @@
+#include <algorithm>
+#include <cstdlib>
 #include "ECS.h"
+#include "Prefab.h"
 #include "../Logger/Logger.h"
 
 int IComponent::nextId = 0;
 
-int Entity::GetId() const {
-	return m_id;
+void Entity::Kill() const {
+	registry->KillEntity(*this);
 }
 
-void Entity::Kill() {
-	registry->KillEntity(*this);
+void Entity::SetActive(bool isActive) const {
+	registry->SetEntityActive(*this, isActive);
+}
+
+bool Entity::IsActive() const {
+	return registry->IsEntityActive(*this);
 }
 
-void Entity::Tag(const std::string& tag) {
+void Entity::Tag(const std::string& tag) const {
 	registry->TagEntity(*this, tag);
 }
 
@@ -19,7 +26,7 @@ bool Entity::HasTag(const std::string& tag) const {
 	return registry->EntityHasTag(*this, tag);
 }
 
-void Entity::Group(const std::string& group) {
+void Entity::Group(const std::string& group) const {
 	registry->GroupEntity(*this, group);
 }
 
@@ -28,16 +35,42 @@ bool Entity::BelongsToGroup(const std::string& group) const {
 }
 
 void System::AddEntityToSystem(Entity entity) {
+	const auto entityId = entity.GetId();
+	if (entityId >= static_cast<int>(m_entityIndices.size())) {
+		m_entityIndices.resize(entityId + 1, -1);
+	}
+	if (m_entityIndices[entityId] != -1) return;
+
+	m_entityIndices[entityId] = static_cast<int>(m_entities.size());
 	m_entities.push_back(entity);
 }
 
 void System::RemoveEntityFromSystem(Entity entity) {
-	m_entities.erase(std::remove_if(m_entities.begin(), m_entities.end(), [&entity](Entity other) {
-		return entity == other;
-	}), m_entities.end());
+	if (!HasEntity(entity)) return;
+
+	const auto entityId = entity.GetId();
+	const int index = m_entityIndices[entityId];
+	const Entity last = m_entities.back();
+
+	m_entities[index] = last;
+	m_entityIndices[last.GetId()] = index;
+	m_entities.pop_back();
+	m_entityIndices[entityId] = -1;
 }
 
-std::vector<Entity> System::GetSystemEntities() const {
+bool System::HasEntity(Entity entity) const {
+	const auto entityId = entity.GetId();
+	return entityId < static_cast<int>(m_entityIndices.size()) && m_entityIndices[entityId] != -1;
+}
+
+void System::ClearEntities() {
+	for (auto entity : m_entities) {
+		m_entityIndices[entity.GetId()] = -1;
+	}
+	m_entities.clear();
+}
+
+const std::vector<Entity>& System::GetSystemEntities() const {
 	return m_entities;
 }
 
@@ -45,13 +78,59 @@ const Signature& System::GetComponentSignature() const {
 	return m_componentSignature;
 }
 
-Entity Registry::CreateEntity() {
+Signature System::GetReadSignature() const {
+	return m_readSignature;
+}
+
+Signature System::GetWriteSignature() const {
+	return m_writeSignature | (m_componentSignature & ~m_readSignature);
+}
+
+bool System::IsExclusive() const {
+	return m_isExclusive;
+}
+
+bool System::ConflictsWith(const System& other) const {
+	if (m_isExclusive || other.m_isExclusive) return true;
+
+	const Signature writes = GetWriteSignature();
+	const Signature otherWrites = other.GetWriteSignature();
+
+	return (writes & (other.GetReadSignature() | otherWrites)).any() || (otherWrites & GetReadSignature()).any();
+}
+
+void System::RequireExclusiveAccess() {
+	m_isExclusive = true;
+}
+
+void System::SetJobSystem(JobSystem* jobSystem) {
+	m_jobSystem = jobSystem;
+}
+
+JobSystem* System::GetJobSystem() const {
+	return m_jobSystem;
+}
+
+int Registry::AcquireEntityId() {
 	int entityId;
 
 	if (m_freeIds.empty()) {
+		// A larger index would spill into the generation bits of the handle
+		// and alias another entity, there is no handle to give back
+		if (m_numOfEntities > static_cast<int>(ENTITY_INDEX_MASK)) {
+			Logger::Error("Entity limit of " + std::to_string(ENTITY_INDEX_MASK + 1) + " reached");
+			std::abort();
+		}
+
 		entityId = m_numOfEntities++;
 		if (entityId >= m_entityComponentSignatures.size()) {
 			m_entityComponentSignatures.resize(entityId + 1);
+			m_entityGenerations.resize(entityId + 1, 0);
+			m_isEntityToBeKilled.resize(entityId + 1, false);
+			m_isEntityInactive.resize(entityId + 1, false);
+			m_isEntityActivityChanged.resize(entityId + 1, false);
+			m_isEntitySignatureChanged.resize(entityId + 1, false);
+			m_entitySystemSignatures.resize(entityId + 1);
 		}
 	}
 	else {
@@ -59,9 +138,14 @@ Entity Registry::CreateEntity() {
 		m_freeIds.pop_front();
 	}
 
-	Entity entity(entityId);
+	return entityId;
+}
+
+Entity Registry::CreateEntity() {
+	const int entityId = AcquireEntityId();
+
+	Entity entity(entityId, m_entityGenerations[entityId]);
 	entity.registry = this;
-	m_entitiesToBeAdded.insert(entity);
 
 	Logger::Success("Entity created with id  = " + std::to_string(entityId));
 
@@ -69,41 +153,178 @@ Entity Registry::CreateEntity() {
 }
 
 void Registry::KillEntity(Entity entity) {
-	m_entitiesToBeKilled.insert(entity);
+	// Systems scheduled in parallel may kill entities concurrently
+	std::lock_guard<std::mutex> lock(m_entitiesToBeKilledMutex);
+
+	// Generations only change in Update, so a stale handle is rejected here
+	// and cannot take the slot of a kill of the live entity
+	if (!IsAlive(entity) || m_isEntityToBeKilled[entity.GetId()]) return;
+
+	m_isEntityToBeKilled[entity.GetId()] = true;
+	m_entitiesToBeKilled.push_back(entity);
+}
+
+std::vector<Entity> Registry::Instantiate(const Prefab& prefab, int count) {
+	const auto& signature = prefab.GetSignature();
+
+	std::vector<Entity> entities;
+	entities.reserve(count);
+
+	for (int i = 0; i < count; i++) {
+		const int entityId = AcquireEntityId();
+
+		Entity entity(entityId, m_entityGenerations[entityId]);
+		entity.registry = this;
+		entities.push_back(entity);
+
+		m_entityComponentSignatures[entityId] = signature;
+		MarkSignatureChanged(entity);
+	}
+
+	for (const auto& component : prefab.GetComponents()) {
+		if (component) component->ReserveStorage(*this);
+	}
+
+#ifdef ECS_ARCHETYPE_STORAGE
+	for (auto entity : entities) {
+		m_archetypeStorage.AddEntity(entity.GetId(), signature);
+	}
+#endif
+
+	for (const auto& component : prefab.GetComponents()) {
+		if (component) component->Write(*this, entities);
+	}
+
+	Logger::Success(std::to_string(count) + " entities instantiated from a prefab");
+
+	return entities;
+}
+
+bool Registry::IsAlive(Entity entity) const {
+	const auto entityId = entity.GetId();
+	return entityId < m_numOfEntities && m_entityGenerations[entityId] == entity.GetGeneration();
+}
+
+Entity Registry::GetEntity(int entityId) {
+	assert(entityId >= 0 && entityId < m_numOfEntities && "GetEntity on an unknown id");
+	Entity entity(entityId, m_entityGenerations[entityId]);
+	entity.registry = this;
+	return entity;
+}
+
+void Registry::SetEntityActive(Entity entity, bool isActive) {
+	// Systems scheduled in parallel may recycle entities concurrently
+	std::lock_guard<std::mutex> lock(m_entityActivityMutex);
+
+	const auto entityId = entity.GetId();
+	if (!IsAlive(entity) || (m_isEntityInactive[entityId] == m_isEntityActivityChanged[entityId]) == isActive) return;
+
+	// Setting it back before the Update cancels the queued change
+	m_isEntityActivityChanged[entityId] = !m_isEntityActivityChanged[entityId];
+	if (m_isEntityActivityChanged[entityId]) {
+		m_entitiesWithChangedActivity.push_back(entity);
+	}
+}
+
+bool Registry::IsEntityActive(Entity entity) const {
+	return IsAlive(entity) && !m_isEntityInactive[entity.GetId()];
+}
+
+bool Registry::WillEntityBeActive(Entity entity) {
+	std::lock_guard<std::mutex> lock(m_entityActivityMutex);
+
+	const auto entityId = entity.GetId();
+	return IsAlive(entity) && m_isEntityInactive[entityId] == m_isEntityActivityChanged[entityId];
+}
+
+void Registry::SetJobSystem(JobSystem* jobSystem) {
+	m_jobSystem = jobSystem;
+
+	for (auto& system : m_systems) {
+		system.second->SetJobSystem(jobSystem);
+	}
+}
+
+void Registry::MarkSignatureChanged(Entity entity) {
+	const auto entityId = entity.GetId();
+	if (m_isEntitySignatureChanged[entityId]) return;
+
+	m_isEntitySignatureChanged[entityId] = true;
+	m_entitiesWithChangedSignature.push_back(entity);
 }
 
-void Registry::AddEntityToSystems(Entity entity) {
+void Registry::UpdateEntitySystems(Entity entity) {
 	const auto entityId = entity.GetId();
-	const auto& entityComponentSignature = m_entityComponentSignatures[entityId];
+	const Signature& entityComponentSignature = m_entityComponentSignatures[entityId];
+	const Signature changedComponents = entityComponentSignature ^ m_entitySystemSignatures[entityId];
+
+	if (changedComponents.none()) return;
 
 	for (auto& system : m_systems) {
 		const auto& systemComponentSignature = system.second->GetComponentSignature();
 
+		if ((systemComponentSignature & changedComponents).none()) continue;
+
 		bool isInterested = (entityComponentSignature & systemComponentSignature) == systemComponentSignature;
 
 		if (isInterested) {
 			system.second->AddEntityToSystem(entity);
 		}
+		else {
+			system.second->RemoveEntityFromSystem(entity);
+		}
 	}
+
+	m_entitySystemSignatures[entityId] = entityComponentSignature;
 }
 
 void Registry::RemoveEntityFromSystems(Entity entity) {
+	const auto& entityComponentSignature = m_entitySystemSignatures[entity.GetId()];
+
 	for (auto& system : m_systems) {
-		system.second->RemoveEntityFromSystem(entity);
+		const auto& systemComponentSignature = system.second->GetComponentSignature();
+
+		if ((entityComponentSignature & systemComponentSignature) == systemComponentSignature) {
+			system.second->RemoveEntityFromSystem(entity);
+		}
 	}
 }
 
 void Registry::Update() {
-	for (auto& entity: m_entitiesToBeAdded) {
-		AddEntityToSystems(entity);
+	// Entities queued more than once were set back and forth, only the
+	// changed flag tells whether a change is still due
+	for (auto& entity : m_entitiesWithChangedActivity) {
+		const auto entityId = entity.GetId();
+		if (!m_isEntityActivityChanged[entityId]) continue;
+
+		m_isEntityActivityChanged[entityId] = false;
+		if (IsAlive(entity)) {
+			m_isEntityInactive[entityId] = !m_isEntityInactive[entityId];
+		}
+	}
+	m_entitiesWithChangedActivity.clear();
+
+	std::sort(m_entitiesWithChangedSignature.begin(), m_entitiesWithChangedSignature.end());
+	for (auto& entity: m_entitiesWithChangedSignature) {
+		m_isEntitySignatureChanged[entity.GetId()] = false;
+		UpdateEntitySystems(entity);
 	}
-	m_entitiesToBeAdded.clear();
+	m_entitiesWithChangedSignature.clear();
 
+	std::sort(m_entitiesToBeKilled.begin(), m_entitiesToBeKilled.end());
 	for (auto& entity : m_entitiesToBeKilled) {
+		m_isEntityToBeKilled[entity.GetId()] = false;
+
 		RemoveEntityFromSystems(entity);
 
 		m_entityComponentSignatures[entity.GetId()].reset();
+		m_entitySystemSignatures[entity.GetId()].reset();
+		m_isEntityInactive[entity.GetId()] = false;
+#ifdef ECS_ARCHETYPE_STORAGE
+		m_archetypeStorage.RemoveEntity(entity.GetId());
+#endif
 
+		m_entityGenerations[entity.GetId()] = (entity.GetGeneration() + 1) & ENTITY_GENERATION_MASK;
 		m_freeIds.push_back(entity.GetId());
 
 		RemoveEntityTag(entity);
@@ -112,6 +333,263 @@ void Registry::Update() {
 	m_entitiesToBeKilled.clear();
 }
 
+// Snapshots
+namespace {
+	const uint32_t SNAPSHOT_MAGIC = 0x53534345; // "ECSS"
+	const uint32_t SNAPSHOT_VERSION = 1;
+}
+
+void Registry::SaveSnapshot(std::ostream& stream) const {
+#ifdef ECS_ARCHETYPE_STORAGE
+	(void)stream;
+	Logger::Error("Registry snapshots are not supported with ECS_ARCHETYPE_STORAGE");
+	return;
+#else
+	WriteValue(stream, SNAPSHOT_MAGIC);
+	WriteValue(stream, SNAPSHOT_VERSION);
+
+	std::vector<uint32_t> signatures(m_numOfEntities);
+	std::vector<uint8_t> isInactive(m_numOfEntities);
+	for (int entityId = 0; entityId < m_numOfEntities; entityId++) {
+		signatures[entityId] = static_cast<uint32_t>(m_entityComponentSignatures[entityId].to_ulong());
+		isInactive[entityId] = m_isEntityInactive[entityId];
+	}
+
+	WriteValue(stream, m_numOfEntities);
+	stream.write(reinterpret_cast<const char*>(m_entityGenerations.data()), m_numOfEntities * sizeof(unsigned int));
+	stream.write(reinterpret_cast<const char*>(signatures.data()), m_numOfEntities * sizeof(uint32_t));
+	stream.write(reinterpret_cast<const char*>(isInactive.data()), m_numOfEntities * sizeof(uint8_t));
+
+	WriteValue(stream, static_cast<uint32_t>(m_freeIds.size()));
+	for (int entityId : m_freeIds) {
+		WriteValue(stream, entityId);
+	}
+
+	WriteValue(stream, static_cast<uint32_t>(m_tagPerEntity.size()));
+	for (const auto& tag : m_tagPerEntity) {
+		WriteValue(stream, tag.first);
+		WriteString(stream, tag.second);
+	}
+
+	WriteValue(stream, static_cast<uint32_t>(m_groupsPerEntity.size()));
+	for (const auto& group : m_groupsPerEntity) {
+		WriteValue(stream, group.first);
+		WriteString(stream, group.second);
+	}
+
+	uint32_t numOfPools = 0;
+	for (const auto& pool : m_componentPools) {
+		if (pool) numOfPools++;
+	}
+
+	// Pool table first so a load can check every type before touching a pool
+	WriteValue(stream, numOfPools);
+	for (size_t componentId = 0; componentId < m_componentPools.size(); componentId++) {
+		if (!m_componentPools[componentId]) continue;
+
+		WriteValue(stream, static_cast<uint32_t>(componentId));
+		WriteString(stream, m_componentPools[componentId]->GetTypeName());
+	}
+	for (const auto& pool : m_componentPools) {
+		if (pool) pool->Save(stream);
+	}
+
+	Logger::Info("Registry snapshot saved with " + std::to_string(m_numOfEntities) + " entities");
+#endif
+}
+
+bool Registry::LoadSnapshot(std::istream& stream) {
+#ifdef ECS_ARCHETYPE_STORAGE
+	(void)stream;
+	Logger::Error("Registry snapshots are not supported with ECS_ARCHETYPE_STORAGE");
+	return false;
+#else
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	ReadValue(stream, magic);
+	ReadValue(stream, version);
+	if (!stream || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+		Logger::Error("Invalid registry snapshot");
+		return false;
+	}
+
+	int numOfEntities = 0;
+	ReadValue(stream, numOfEntities);
+	if (!stream || numOfEntities < 0 || numOfEntities > static_cast<int>(ENTITY_INDEX_MASK) + 1) {
+		Logger::Error("Invalid registry snapshot");
+		return false;
+	}
+
+	std::vector<unsigned int> savedGenerations(numOfEntities);
+	std::vector<uint32_t> savedSignatures(numOfEntities);
+	std::vector<uint8_t> savedIsInactive(numOfEntities);
+	stream.read(reinterpret_cast<char*>(savedGenerations.data()), numOfEntities * sizeof(unsigned int));
+	stream.read(reinterpret_cast<char*>(savedSignatures.data()), numOfEntities * sizeof(uint32_t));
+	stream.read(reinterpret_cast<char*>(savedIsInactive.data()), numOfEntities * sizeof(uint8_t));
+
+	auto isValidId = [numOfEntities](int entityId) {
+		return entityId >= 0 && entityId < numOfEntities;
+	};
+
+	uint32_t numOfFreeIds = 0;
+	ReadValue(stream, numOfFreeIds);
+	if (!stream || numOfFreeIds > static_cast<uint32_t>(numOfEntities)) {
+		Logger::Error("Invalid registry snapshot");
+		return false;
+	}
+	std::deque<int> freeIds(numOfFreeIds);
+	std::vector<bool> isFree(numOfEntities, false);
+	for (auto& entityId : freeIds) {
+		ReadValue(stream, entityId);
+		if (!stream || !isValidId(entityId) || isFree[entityId]) {
+			Logger::Error("Registry snapshot has an invalid free entity id");
+			return false;
+		}
+		isFree[entityId] = true;
+	}
+
+	// An entity has at most one tag and one group
+	auto readNames = [&stream, numOfEntities, &isValidId, &isFree](std::vector<std::pair<int, std::string>>& names) {
+		uint32_t numOfNames = 0;
+		ReadValue(stream, numOfNames);
+		if (!stream || numOfNames > static_cast<uint32_t>(numOfEntities)) return false;
+
+		names.resize(numOfNames);
+		for (auto& name : names) {
+			ReadValue(stream, name.first);
+			ReadString(stream, name.second);
+			if (!stream || !isValidId(name.first) || isFree[name.first]) return false;
+		}
+		return true;
+	};
+	std::vector<std::pair<int, std::string>> tags;
+	std::vector<std::pair<int, std::string>> groups;
+	if (!readNames(tags) || !readNames(groups)) {
+		Logger::Error("Registry snapshot has an invalid tag or group");
+		return false;
+	}
+
+	uint32_t numOfPools = 0;
+	ReadValue(stream, numOfPools);
+	if (!stream || numOfPools > MAX_COMPONENTS) {
+		Logger::Error("Invalid registry snapshot");
+		return false;
+	}
+	std::vector<uint32_t> poolComponentIds(numOfPools);
+	for (auto& componentId : poolComponentIds) {
+		std::string typeName;
+		ReadValue(stream, componentId);
+		ReadString(stream, typeName);
+
+		if (!stream || componentId >= m_componentPools.size() || !m_componentPools[componentId] || typeName != m_componentPools[componentId]->GetTypeName()) {
+			Logger::Error("Registry snapshot has no matching pool for component " + typeName);
+			return false;
+		}
+	}
+
+	// Loaded aside and swapped in only once the whole snapshot checks out
+	std::vector<std::shared_ptr<IPool>> loadedPools(m_componentPools.size());
+	for (auto componentId : poolComponentIds) {
+		loadedPools[componentId] = m_componentPools[componentId]->Load(stream);
+		if (!stream) break;
+	}
+
+	if (!stream) {
+		Logger::Error("Registry snapshot is truncated");
+		return false;
+	}
+
+	// Every component an entity has must be in a loaded pool that covers it
+	for (int entityId = 0; entityId < numOfEntities; entityId++) {
+		const Signature signature(savedSignatures[entityId]);
+		for (size_t componentId = 0; componentId < MAX_COMPONENTS; componentId++) {
+			if (!signature.test(componentId)) continue;
+
+			if (componentId >= loadedPools.size() || !loadedPools[componentId] || entityId >= loadedPools[componentId]->GetSize()) {
+				Logger::Error("Registry snapshot has a component outside its pool");
+				return false;
+			}
+		}
+	}
+
+	// Ids the current state uses past the end of the snapshot stay allocated
+	// as free ids, so every id keeps a generation newer than both the
+	// snapshot and the current state and no handle from before the load
+	// stays valid
+	const int numOfIds = std::max(numOfEntities, m_numOfEntities);
+	const size_t numOfGenerations = std::max(static_cast<size_t>(numOfIds), m_entityGenerations.size());
+	std::vector<unsigned int> generations(numOfGenerations, 0);
+	for (size_t entityId = 0; entityId < numOfGenerations; entityId++) {
+		unsigned int generation = 0;
+		if (entityId < savedGenerations.size()) {
+			generation = savedGenerations[entityId];
+		}
+		if (entityId < m_entityGenerations.size()) {
+			generation = std::max(generation, m_entityGenerations[entityId]);
+		}
+		generations[entityId] = (generation + 1) & ENTITY_GENERATION_MASK;
+	}
+	for (int entityId = numOfEntities; entityId < numOfIds; entityId++) {
+		freeIds.push_back(entityId);
+	}
+
+	std::vector<Signature> signatures(numOfGenerations);
+	std::vector<bool> isInactive(numOfGenerations, false);
+	for (int entityId = 0; entityId < numOfEntities; entityId++) {
+		signatures[entityId] = Signature(savedSignatures[entityId]);
+		isInactive[entityId] = savedIsInactive[entityId] != 0;
+	}
+
+	for (auto componentId : poolComponentIds) {
+		m_componentPools[componentId] = loadedPools[componentId];
+	}
+
+	for (auto& system : m_systems) {
+		system.second->ClearEntities();
+	}
+
+	m_numOfEntities = numOfIds;
+	m_entityGenerations = std::move(generations);
+	m_entityComponentSignatures = std::move(signatures);
+	m_isEntityInactive = std::move(isInactive);
+	m_isEntityActivityChanged.assign(numOfGenerations, false);
+	m_entitiesWithChangedActivity.clear();
+	m_freeIds = std::move(freeIds);
+	m_entitySystemSignatures.assign(numOfGenerations, Signature());
+	m_isEntityToBeKilled.assign(numOfGenerations, false);
+	m_isEntitySignatureChanged.assign(numOfGenerations, false);
+	m_entitiesToBeKilled.clear();
+	m_entitiesWithChangedSignature.clear();
+
+	for (int entityId = 0; entityId < numOfEntities; entityId++) {
+		if (isFree[entityId]) continue;
+
+		Entity entity(entityId, m_entityGenerations[entityId]);
+		entity.registry = this;
+		MarkSignatureChanged(entity);
+	}
+
+	m_entityPerTag.clear();
+	m_tagPerEntity.clear();
+	for (const auto& tag : tags) {
+		Entity entity(tag.first, m_entityGenerations[tag.first]);
+		entity.registry = this;
+		TagEntity(entity, tag.second);
+	}
+
+	m_entitiesPerGroup.clear();
+	m_groupsPerEntity.clear();
+	for (const auto& group : groups) {
+		Entity entity(group.first, m_entityGenerations[group.first]);
+		entity.registry = this;
+		GroupEntity(entity, group.second);
+	}
+
+	Logger::Info("Registry snapshot loaded with " + std::to_string(m_numOfEntities) + " entities");
+	return true;
+#endif
+}
+
 // Tag management
 void Registry::TagEntity(Entity entity, const std::string& tag) {
 	m_entityPerTag.emplace(tag, entity);
@@ -145,7 +623,7 @@ void Registry::GroupEntity(Entity entity, const std::string& group) {
 
 bool Registry::EntityBelongsToGroup(Entity entity, const std::string& group) const {
 	auto groupEntities = m_entitiesPerGroup.at(group);
-	return groupEntities.find(entity.GetId()) != groupEntities.end();
+	return groupEntities.find(entity) != groupEntities.end();
 }
 
 std::vector<Entity> Registry::GetEntitiesByGroup(const std::string& group) const {
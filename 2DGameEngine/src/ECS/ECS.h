@@ -1,19 +1,30 @@
 #ifndef ECS_H
 #define ECS_H
 
-#include <bitset>
 #include <vector>
 #include <unordered_map>
 #include <typeindex>
 #include <set>
 #include <memory>
 #include <deque>
+#include <mutex>
+#include <tuple>
+#include <cassert>
+#include <istream>
+#include <ostream>
+#include <typeinfo>
 
 #include "../Logger/Logger.h"
+#include "../Jobs/JobSystem.h"
+#include "Signature.h"
+#include "Serialization.h"
 
-const unsigned int MAX_COMPONENTS = 32;
-
-typedef std::bitset<MAX_COMPONENTS> Signature;
+// Define ECS_ARCHETYPE_STORAGE in the preprocessor definitions to keep
+// components in archetype tables (see ArchetypeStorage.h) instead of one
+// Pool per component type. The Registry API is the same for both.
+#ifdef ECS_ARCHETYPE_STORAGE
+#include "ArchetypeStorage.h"
+#endif
 
 struct IComponent {
 	protected:
@@ -29,30 +40,44 @@ class Component: public IComponent {
 		}
 };
 
+// An entity handle packs the index into the low bits and a generation into
+// the high bits. The generation is bumped every time an index is recycled,
+// so handles kept after the entity was killed no longer compare equal and
+// Registry::IsAlive reports them as dead. Creating an entity past the
+// 2^20 live indices aborts.
+const unsigned int ENTITY_INDEX_BITS = 20;
+const unsigned int ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+const unsigned int ENTITY_GENERATION_MASK = (1u << (32 - ENTITY_INDEX_BITS)) - 1;
+
 class Entity {
 	private:
-		int m_id;
+		unsigned int m_id;
 
 	public:
-		Entity(int id): m_id(id) {};
+		Entity(int id, unsigned int generation = 0): m_id((generation << ENTITY_INDEX_BITS) | static_cast<unsigned int>(id)) {};
 		Entity(const Entity& entity) = default;
 
-		int GetId() const;
-		void Kill();
+		int GetId() const { return static_cast<int>(m_id & ENTITY_INDEX_MASK); }
+		unsigned int GetGeneration() const { return m_id >> ENTITY_INDEX_BITS; }
+		void Kill() const;
+		void SetActive(bool isActive) const;
+		bool IsActive() const;
 
-		void Tag(const std::string& tag);
+		void Tag(const std::string& tag) const;
 		bool HasTag(const std::string& tag) const;
-		void Group(const std::string& group);
+		void Group(const std::string& group) const;
 		bool BelongsToGroup(const std::string& group) const;
 		
 		Entity& operator =(const Entity& other) = default;
 		bool operator ==(const Entity& other) const { return m_id == other.m_id; }
 		bool operator !=(const Entity& other) const { return m_id != other.m_id; }
-		bool operator >(const Entity& other) const { return m_id > other.m_id; }
-		bool operator <(const Entity& other) const { return m_id < other.m_id; }
+		bool operator >(const Entity& other) const { return other < *this; }
+		bool operator <(const Entity& other) const {
+			return GetId() < other.GetId() || (GetId() == other.GetId() && GetGeneration() < other.GetGeneration());
+		}
 
-		template <typename TComponent, typename ...TArgs> void AddComponent(TArgs... args);
-		template <typename TComponent> void RemoveComponent();
+		template <typename TComponent, typename ...TArgs> void AddComponent(TArgs... args) const;
+		template <typename TComponent> void RemoveComponent() const;
 		template <typename TComponent> bool HasComponent() const;
 		template <typename TComponent> TComponent& GetComponent() const;
 
@@ -62,23 +87,59 @@ class Entity {
 class System {
 	private:
 		Signature m_componentSignature;
+		Signature m_readSignature;
+		Signature m_writeSignature;
+		bool m_isExclusive = false;
 		std::vector<Entity> m_entities;
+		// Position of each entity id in m_entities, -1 when not in the system
+		std::vector<int> m_entityIndices;
+		JobSystem* m_jobSystem = nullptr;
 
 	public:
 		System() = default;
 		~System() = default;
 
 		void AddEntityToSystem(Entity entity);
+		// Swaps the last entity into the hole, so the order is not preserved
 		void RemoveEntityFromSystem(Entity entity);
-		std::vector<Entity> GetSystemEntities() const;
+		bool HasEntity(Entity entity) const;
+		void ClearEntities();
+		// Includes inactive entities, loops skip them with Entity::IsActive
+		const std::vector<Entity>& GetSystemEntities() const;
 		const Signature& GetComponentSignature() const;
 
+		// Component access used by the scheduler, required components that are
+		// not declared as read-only count as written
+		Signature GetReadSignature() const;
+		Signature GetWriteSignature() const;
+		bool IsExclusive() const;
+		bool ConflictsWith(const System& other) const;
+
 		template <typename TComponent> void RequireComponent();
+		template <typename TComponent> void ReadsComponent();
+		template <typename TComponent> void WritesComponent();
+		// For systems that create entities, add components or emit events
+		void RequireExclusiveAccess();
+
+		// Without a job system ParallelEach runs serially on the calling thread,
+		// inactive entities are skipped
+		void SetJobSystem(JobSystem* jobSystem);
+		JobSystem* GetJobSystem() const;
+		template <typename TFunc> void ParallelEach(TFunc func, size_t grainSize = 256);
 };
 
 class IPool {
 	public:
 		virtual ~IPool() {}
+
+		// Snapshots, trivially copyable components are copied as one block and
+		// the others must provide Serialize/Deserialize
+		virtual const char* GetTypeName() const = 0;
+		virtual int GetSize() const = 0;
+		virtual void Save(std::ostream& stream) const = 0;
+		// Reads into a new pool and leaves this one untouched, the stream
+		// fails on a size no registry can hold
+		virtual std::shared_ptr<IPool> Load(std::istream& stream) const = 0;
 };
 
 template <typename T>
@@ -93,7 +154,7 @@ class Pool: public IPool {
 		virtual ~Pool() = default;
 
 		bool isEmpty() const { return m_data.empty(); }
-		int GetSize() const { return m_data.size(); }
+		int GetSize() const override { return m_data.size(); }
 		void Resize(int newSize) { m_data.resize(newSize); }
 		void Clear() { m_data.clear(); }
 		void Add(T object) { m_data.push_back(object); }
@@ -101,17 +162,75 @@ class Pool: public IPool {
 		T& Get(int index) { return static_cast<T&>(m_data[index]); }
 		
 		T& operator [](unsigned int index) { return m_data[index]; }
+
+		const char* GetTypeName() const override { return typeid(T).name(); }
+
+		void Save(std::ostream& stream) const override {
+			WriteValue(stream, static_cast<uint32_t>(m_data.size()));
+			if constexpr (std::is_trivially_copyable<T>::value) {
+				stream.write(reinterpret_cast<const char*>(m_data.data()), m_data.size() * sizeof(T));
+			}
+			else {
+				for (const auto& component : m_data) {
+					component.Serialize(stream);
+				}
+			}
+		}
+
+		std::shared_ptr<IPool> Load(std::istream& stream) const override {
+			uint32_t size = 0;
+			ReadValue(stream, size);
+			if (!stream || size > ENTITY_INDEX_MASK + 1) {
+				stream.setstate(std::ios::failbit);
+				return nullptr;
+			}
+
+			auto pool = std::make_shared<Pool<T>>(static_cast<int>(size));
+			if constexpr (std::is_trivially_copyable<T>::value) {
+				stream.read(reinterpret_cast<char*>(pool->m_data.data()), pool->m_data.size() * sizeof(T));
+			}
+			else {
+				for (auto& component : pool->m_data) {
+					if (!stream) break;
+					component.Deserialize(stream);
+				}
+			}
+			return pool;
+		}
 };
 
+// Initial capacity of the pending add/kill queues, they keep growing as needed
+const unsigned int PENDING_ENTITIES_RESERVE = 1024;
+
+class Prefab;
+template <typename TComponent> class PrefabComponent;
+
 class Registry {
 	private:
 		int m_numOfEntities = 0;
-		std::vector<std::shared_ptr<IPool>> m_componentPools;	
+#ifdef ECS_ARCHETYPE_STORAGE
+		ArchetypeStorage m_archetypeStorage;
+#else
+		std::vector<std::shared_ptr<IPool>> m_componentPools;
+#endif
 		std::vector<Signature> m_entityComponentSignatures;
+		std::vector<unsigned int> m_entityGenerations;
 		std::unordered_map<std::type_index, std::shared_ptr<System>> m_systems;
 
-		std::set<Entity> m_entitiesToBeAdded;
-		std::set<Entity> m_entitiesToBeKilled;
+		// Pending changes, sorted by id in Update. The bitsets drop duplicates.
+		// Entities whose signature changed are re-matched against the systems
+		// there, m_entitySystemSignatures is the signature the systems last saw.
+		std::vector<Entity> m_entitiesWithChangedSignature;
+		std::vector<bool> m_isEntitySignatureChanged;
+		std::vector<Signature> m_entitySystemSignatures;
+		std::vector<Entity> m_entitiesToBeKilled;
+		std::vector<bool> m_isEntityToBeKilled;
+		// Inactive entities keep their id, components and system membership,
+		// systems skip them. Changes are queued like kills and flipped in
+		// Update, so the flags never change while systems run.
+		std::vector<bool> m_isEntityInactive;
+		std::vector<Entity> m_entitiesWithChangedActivity;
+		std::vector<bool> m_isEntityActivityChanged;
 
 		std::unordered_map<std::string, Entity> m_entityPerTag;
 		std::unordered_map<int, std::string> m_tagPerEntity;
@@ -121,8 +240,23 @@ class Registry {
 
 		std::deque<int> m_freeIds;
 
+		std::mutex m_entitiesToBeKilledMutex;
+		std::mutex m_entityActivityMutex;
+
+		JobSystem* m_jobSystem = nullptr;
+
+		int AcquireEntityId();
+		void MarkSignatureChanged(Entity entity);
+
+		// Bulk component writes used by Instantiate
+		template <typename TComponent> friend class PrefabComponent;
+		template <typename TComponent> void ReserveComponentStorage();
+		template <typename TComponent> void WriteComponent(const std::vector<Entity>& entities, const TComponent& component);
+
 	public:
 		Registry() {
+			m_entitiesWithChangedSignature.reserve(PENDING_ENTITIES_RESERVE);
+			m_entitiesToBeKilled.reserve(PENDING_ENTITIES_RESERVE);
 			Logger::Info("Game Registry Created");
 		};
 
@@ -135,6 +269,20 @@ class Registry {
 		// Entity management
 		Entity CreateEntity();
 		void KillEntity(Entity entity);
+		bool IsAlive(Entity entity) const;
+		// Current handle of a live entity id, for ids that crossed a boundary
+		// without their generation (script batches)
+		Entity GetEntity(int entityId);
+		// Ids below it have been handed out, free ones included
+		int GetNumOfEntities() const { return m_numOfEntities; }
+		// Takes effect for the systems on the next Update, like KillEntity
+		void SetEntityActive(Entity entity, bool isActive);
+		// As the systems see it until the next Update
+		bool IsEntityActive(Entity entity) const;
+		// Including changes queued since the last Update
+		bool WillEntityBeActive(Entity entity);
+		// Creates `count` entities with the prefab's components, see Prefab.h
+		std::vector<Entity> Instantiate(const Prefab& prefab, int count = 1);
 
 		// Tag management
 		void TagEntity(Entity entity, const std::string& tag);
@@ -153,6 +301,10 @@ class Registry {
 		template <typename TComponent> void RemoveComponent(Entity entity);
 		template <typename TComponent> bool HasComponent(Entity entity) const;
 		template <typename TComponent> TComponent& GetComponent(Entity entity) const;
+
+		// Calls func(entity, components&...) for every active entity that has all
+		// the components, with the archetype storage this walks packed columns
+		template <typename ...TComponents, typename TFunc> void Query(TFunc func);
 		
 		// System management
 		template <typename TSystem, typename ...TArgs> void AddSystem(TArgs&& ...args);
@@ -160,16 +312,58 @@ class Registry {
 		template <typename TSystem> bool HasSystem() const;
 		template <typename TSystem> TSystem& GetSystem() const;
 
-		void AddEntityToSystems(Entity entity);
+		void SetJobSystem(JobSystem* jobSystem);
+
+		// Binary snapshot of the entities, their signatures, tags, groups and
+		// component pools. Loading replaces the current state, rebuilds system
+		// membership on the next Update and bumps every generation, so handles
+		// taken before the load are dead. The component types of the snapshot
+		// must already have a pool (same build, components used before). A
+		// truncated or malformed snapshot is rejected with the state untouched.
+		void SaveSnapshot(std::ostream& stream) const;
+		bool LoadSnapshot(std::istream& stream);
+
+		// Adds or removes the entity from the systems whose required components
+		// overlap its signature change. Systems that require no components are
+		// never matched.
+		void UpdateEntitySystems(Entity entity);
 		void RemoveEntityFromSystems(Entity entity);
 };
 
 // Component management
 template <typename TComponent, typename ...TArgs> 
 void Registry::AddComponent(Entity entity, TArgs&& ...args) {
+	assert(IsAlive(entity) && "AddComponent on a dead entity");
 	const auto componentId = Component<TComponent>::GetId();
 	const auto entityId = entity.GetId();
 
+#ifdef ECS_ARCHETYPE_STORAGE
+	m_archetypeStorage.AddComponent(entityId, componentId, TComponent(std::forward<TArgs>(args)...));
+#else
+	ReserveComponentStorage<TComponent>();
+
+	std::shared_ptr<Pool<TComponent>> componentPool = std::static_pointer_cast<Pool<TComponent>>(m_componentPools[componentId]);
+
+	TComponent newComponent(std::forward<TArgs>(args)...);
+
+	componentPool->Set(entityId, newComponent);
+#endif
+
+	if (!m_entityComponentSignatures[entityId].test(componentId)) {
+		m_entityComponentSignatures[entityId].set(componentId);
+		MarkSignatureChanged(entity);
+	}
+
+	Logger::Info("Component id = " + std::to_string(componentId) + " was added to entity: " + std::to_string(entityId));
+}
+
+template <typename TComponent>
+void Registry::ReserveComponentStorage() {
+	const auto componentId = Component<TComponent>::GetId();
+
+#ifdef ECS_ARCHETYPE_STORAGE
+	m_archetypeStorage.RegisterComponentType<TComponent>(componentId);
+#else
 	if (componentId >= m_componentPools.size()) {
 		m_componentPools.resize(componentId + 1, nullptr);
 	}
@@ -179,27 +373,46 @@ void Registry::AddComponent(Entity entity, TArgs&& ...args) {
 		m_componentPools[componentId] = newComponentPool;
 	}
 
-	std::shared_ptr<Pool<TComponent>> componentPool = std::static_pointer_cast<Pool<TComponent>>(m_componentPools[componentId]);
+	auto componentPool = static_cast<Pool<TComponent>*>(m_componentPools[componentId].get());
 
-	if (entityId >= componentPool->GetSize()) {
+	if (m_numOfEntities > componentPool->GetSize()) {
 		componentPool->Resize(m_numOfEntities);
 	}
+#endif
+}
 
-	TComponent newComponent(std::forward<TArgs>(args)...);
-
-	componentPool->Set(entityId, newComponent);
+// Expects the entities to have been placed with the prefab signature
+template <typename TComponent>
+void Registry::WriteComponent(const std::vector<Entity>& entities, const TComponent& component) {
+	const auto componentId = Component<TComponent>::GetId();
 
-	m_entityComponentSignatures[entityId].set(componentId);
+#ifdef ECS_ARCHETYPE_STORAGE
+	for (auto entity : entities) {
+		m_archetypeStorage.ConstructComponent(entity.GetId(), componentId, component);
+	}
+#else
+	auto componentPool = static_cast<Pool<TComponent>*>(m_componentPools[componentId].get());
 
-	Logger::Info("Component id = " + std::to_string(componentId) + " was added to entity: " + std::to_string(entityId));
+	for (auto entity : entities) {
+		componentPool->Set(entity.GetId(), component);
+	}
+#endif
 }
 
 template <typename TComponent>
 void Registry::RemoveComponent(Entity entity) {
+	assert(IsAlive(entity) && "RemoveComponent on a dead entity");
 	const auto componentId = Component<TComponent>::GetId();
 	const auto entityId = entity.GetId();
 
-	m_entityComponentSignatures[entityId].set(componentId, false);
+	if (m_entityComponentSignatures[entityId].test(componentId)) {
+		m_entityComponentSignatures[entityId].set(componentId, false);
+		MarkSignatureChanged(entity);
+	}
+
+#ifdef ECS_ARCHETYPE_STORAGE
+	m_archetypeStorage.RemoveComponent(entityId, componentId);
+#endif
 
 	Logger::Info("Component id = " + std::to_string(componentId) + " was removed from entity: " + std::to_string(entityId));
 }
@@ -209,16 +422,54 @@ bool Registry::HasComponent(Entity entity) const {
 	const auto componentId = Component<TComponent>::GetId();
 	const auto entityId = entity.GetId();
 
-	return m_entityComponentSignatures[entityId].test(componentId);
+	return IsAlive(entity) && m_entityComponentSignatures[entityId].test(componentId);
 }
 
 template <typename TComponent>
 TComponent& Registry::GetComponent(Entity entity) const {
+	assert(IsAlive(entity) && "GetComponent on a dead entity");
 	const auto componentId = Component<TComponent>::GetId();
 	const auto entityId = entity.GetId();
-	auto componentPool = std::static_pointer_cast<Pool<TComponent>>(m_componentPools[componentId]);
+
+#ifdef ECS_ARCHETYPE_STORAGE
+	return m_archetypeStorage.GetComponent<TComponent>(entityId, componentId);
+#else
+	// Raw pointer cast: copying the shared_ptr here would make every component
+	// access touch the shared reference count, which systems running on
+	// several threads fight over
+	auto componentPool = static_cast<Pool<TComponent>*>(m_componentPools[componentId].get());
 
 	return componentPool->Get(entityId);
+#endif
+}
+
+template <typename ...TComponents, typename TFunc>
+void Registry::Query(TFunc func) {
+	Signature signature;
+	(signature.set(Component<TComponents>::GetId()), ...);
+
+#ifdef ECS_ARCHETYPE_STORAGE
+	m_archetypeStorage.ForEachChunk(signature, [this, &func](const ArchetypeChunk& chunk, const Archetype& archetype) {
+		auto columns = std::make_tuple(archetype.GetColumn<TComponents>(chunk, Component<TComponents>::GetId())...);
+
+		for (unsigned int row = 0; row < chunk.GetCount(); row++) {
+			const int entityId = chunk.entityIds[row];
+			if (m_isEntityInactive[entityId]) continue;
+
+			Entity entity(entityId, m_entityGenerations[entityId]);
+			entity.registry = this;
+			func(entity, std::get<TComponents*>(columns)[row]...);
+		}
+	});
+#else
+	for (int entityId = 0; entityId < m_numOfEntities; entityId++) {
+		if ((m_entityComponentSignatures[entityId] & signature) != signature || m_isEntityInactive[entityId]) continue;
+
+		Entity entity(entityId, m_entityGenerations[entityId]);
+		entity.registry = this;
+		func(entity, GetComponent<TComponents>(entity)...);
+	}
+#endif
 }
 
 // System management
@@ -228,9 +479,38 @@ void System::RequireComponent() {
 	m_componentSignature.set(componentId);
 }
 
+template <typename TComponent>
+void System::ReadsComponent() {
+	const auto componentId = Component<TComponent>::GetId();
+	m_readSignature.set(componentId);
+}
+
+template <typename TComponent>
+void System::WritesComponent() {
+	const auto componentId = Component<TComponent>::GetId();
+	m_writeSignature.set(componentId);
+}
+
+template <typename TFunc>
+void System::ParallelEach(TFunc func, size_t grainSize) {
+	if (!m_jobSystem) {
+		for (auto entity : m_entities) {
+			if (entity.IsActive()) func(entity);
+		}
+		return;
+	}
+
+	m_jobSystem->ParallelFor(m_entities.size(), grainSize, [this, &func](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			if (m_entities[i].IsActive()) func(m_entities[i]);
+		}
+	});
+}
+
 template <typename TSystem, typename ...TArgs> 
 void Registry::AddSystem(TArgs&& ...args) {
 	std::shared_ptr<TSystem> newSystem = std::make_shared<TSystem>(std::forward<TArgs>(args)...);
+	newSystem->SetJobSystem(m_jobSystem);
 	m_systems.insert(std::make_pair(std::type_index(typeid(TSystem)), newSystem));
 }
 
@@ -253,12 +533,12 @@ TSystem& Registry::GetSystem() const {
 
 // Entity
 template <typename TComponent, typename ...TArgs>
-void Entity::AddComponent(TArgs ...args) {
+void Entity::AddComponent(TArgs ...args) const {
 	registry->AddComponent<TComponent>(*this, std::forward<TArgs>(args)...);
 }
 
 template <typename TComponent>
-void Entity::RemoveComponent() {
+void Entity::RemoveComponent() const {
 	registry->RemoveComponent<TComponent>(*this);
 }
 
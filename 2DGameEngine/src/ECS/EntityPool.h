@@ -0,0 +1,81 @@
+#ifndef ENTITYPOOL_H
+#define ENTITYPOOL_H
+
+#include <vector>
+
+#include "ECS.h"
+#include "Prefab.h"
+
+// Recycles short-lived entities made from a prefab. Instead of killing an
+// entity, deactivate it (Entity::SetActive(false)): it stays in its systems,
+// which skip it, keeps its id and components, and Acquire hands it out
+// again. The pool never creates more than `capacity` entities.
+class EntityPool {
+	private:
+		int m_capacity;
+		std::vector<Entity> m_entities;
+		size_t m_nextIndex = 0;
+
+	public:
+		EntityPool(int capacity = 0): m_capacity(capacity) {}
+
+		// Gives an inactive entity reset to the prefab values, or a new one while
+		// the pool is below capacity. Returns false when every entity is in use.
+		bool Acquire(Registry& registry, const Prefab& prefab, Entity& entity);
+
+		// Kills the idle entities and returns the ones still in use, which are
+		// no longer the pool's. The pool is empty afterwards.
+		std::vector<Entity> Release(Registry& registry);
+
+		int GetCapacity() const { return m_capacity; }
+		size_t GetSize() const { return m_entities.size(); }
+};
+
+// Entities are released in roughly the order they were acquired, so the
+// search starts after the last one handed out
+inline bool EntityPool::Acquire(Registry& registry, const Prefab& prefab, Entity& entity) {
+	for (size_t i = 0; i < m_entities.size(); i++) {
+		const size_t index = (m_nextIndex + i) % m_entities.size();
+		Entity& candidate = m_entities[index];
+
+		if (!registry.IsAlive(candidate)) {
+			candidate = registry.Instantiate(prefab).front();
+		}
+		else if (!registry.WillEntityBeActive(candidate)) {
+			prefab.ApplyTo(candidate);
+			registry.SetEntityActive(candidate, true);
+		}
+		else {
+			continue;
+		}
+
+		m_nextIndex = index + 1;
+		entity = candidate;
+		return true;
+	}
+
+	if (static_cast<int>(m_entities.size()) >= m_capacity) return false;
+
+	m_entities.push_back(registry.Instantiate(prefab).front());
+	m_nextIndex = 0;
+	entity = m_entities.back();
+	return true;
+}
+
+inline std::vector<Entity> EntityPool::Release(Registry& registry) {
+	std::vector<Entity> entitiesInUse;
+	for (auto& entity : m_entities) {
+		if (registry.WillEntityBeActive(entity)) {
+			entitiesInUse.push_back(entity);
+		}
+		else if (registry.IsAlive(entity)) {
+			registry.KillEntity(entity);
+		}
+	}
+
+	m_entities.clear();
+	m_nextIndex = 0;
+	return entitiesInUse;
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef PREFAB_H
+#define PREFAB_H
+
+#include <memory>
+#include <vector>
+
+#include "ECS.h"
+
+class IPrefabComponent {
+	public:
+		virtual ~IPrefabComponent() = default;
+
+		virtual void ReserveStorage(Registry& registry) const = 0;
+		virtual void Write(Registry& registry, const std::vector<Entity>& entities) const = 0;
+		virtual void Assign(Entity entity) const = 0;
+};
+
+template <typename TComponent>
+class PrefabComponent: public IPrefabComponent {
+	private:
+		TComponent m_component;
+
+	public:
+		PrefabComponent(const TComponent& component): m_component(component) {}
+
+		TComponent& Get() { return m_component; }
+
+		void ReserveStorage(Registry& registry) const override {
+			registry.ReserveComponentStorage<TComponent>();
+		}
+
+		void Write(Registry& registry, const std::vector<Entity>& entities) const override {
+			registry.WriteComponent(entities, m_component);
+		}
+
+		void Assign(Entity entity) const override {
+			entity.GetComponent<TComponent>() = m_component;
+		}
+};
+
+// Template for entities that are spawned often: the signature plus the
+// value every component starts with. Registry::Instantiate creates a batch
+// of entities from it and writes each component for the whole batch at once.
+class Prefab {
+	private:
+		Signature m_signature;
+		std::vector<std::unique_ptr<IPrefabComponent>> m_componentPerId;
+
+	public:
+		Prefab() = default;
+
+		template <typename TComponent, typename ...TArgs> void AddComponent(TArgs&& ...args);
+		template <typename TComponent> bool HasComponent() const;
+		// Changes the value the next instantiated entities get
+		template <typename TComponent> TComponent& GetComponent();
+
+		// Resets the components of an entity that already has the signature
+		void ApplyTo(Entity entity) const;
+
+		const Signature& GetSignature() const { return m_signature; }
+		const std::vector<std::unique_ptr<IPrefabComponent>>& GetComponents() const { return m_componentPerId; }
+};
+
+template <typename TComponent, typename ...TArgs>
+void Prefab::AddComponent(TArgs&& ...args) {
+	const auto componentId = Component<TComponent>::GetId();
+
+	if (componentId >= static_cast<int>(m_componentPerId.size())) {
+		m_componentPerId.resize(componentId + 1);
+	}
+
+	m_componentPerId[componentId] = std::make_unique<PrefabComponent<TComponent>>(TComponent(std::forward<TArgs>(args)...));
+	m_signature.set(componentId);
+}
+
+inline void Prefab::ApplyTo(Entity entity) const {
+	for (const auto& component : m_componentPerId) {
+		if (component) component->Assign(entity);
+	}
+}
+
+template <typename TComponent>
+bool Prefab::HasComponent() const {
+	return m_signature.test(Component<TComponent>::GetId());
+}
+
+template <typename TComponent>
+TComponent& Prefab::GetComponent() {
+	const auto componentId = Component<TComponent>::GetId();
+	return static_cast<PrefabComponent<TComponent>*>(m_componentPerId[componentId].get())->Get();
+}
+
+#endif
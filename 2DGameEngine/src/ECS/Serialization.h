@@ -0,0 +1,44 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+// Binary helpers for snapshots, values are written in the native layout so a
+// snapshot is only meant to be loaded by the same build
+// Longest string a snapshot may hold, a larger size means a corrupt stream
+const uint32_t MAX_SERIALIZED_STRING_SIZE = 1u << 20;
+
+template <typename T>
+void WriteValue(std::ostream& stream, const T& value) {
+	static_assert(std::is_trivially_copyable<T>::value, "WriteValue needs a trivially copyable type");
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void ReadValue(std::istream& stream, T& value) {
+	static_assert(std::is_trivially_copyable<T>::value, "ReadValue needs a trivially copyable type");
+	stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+inline void WriteString(std::ostream& stream, const std::string& value) {
+	WriteValue(stream, static_cast<uint32_t>(value.size()));
+	stream.write(value.data(), value.size());
+}
+
+inline void ReadString(std::istream& stream, std::string& value) {
+	uint32_t size = 0;
+	ReadValue(stream, size);
+	if (!stream || size > MAX_SERIALIZED_STRING_SIZE) {
+		stream.setstate(std::ios::failbit);
+		value.clear();
+		return;
+	}
+	value.resize(size);
+	stream.read(&value[0], size);
+}
+
+#endif
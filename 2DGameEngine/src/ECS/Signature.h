@@ -0,0 +1,10 @@
+#ifndef SIGNATURE_H
+#define SIGNATURE_H
+
+#include <bitset>
+
+const unsigned int MAX_COMPONENTS = 32;
+
+typedef std::bitset<MAX_COMPONENTS> Signature;
+
+#endif
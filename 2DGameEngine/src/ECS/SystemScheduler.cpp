@@ -0,0 +1,85 @@
+#include <chrono>
+
+#include "SystemScheduler.h"
+#include "../Profiler/Profiler.h"
+#include "../Logger/Logger.h"
+
+SystemScheduler::SystemScheduler(JobSystem& jobSystem): m_jobSystem(jobSystem) {
+}
+
+void SystemScheduler::Clear() {
+	m_tasks.clear();
+	m_isGraphDirty = false;
+}
+
+void SystemScheduler::BuildGraph() {
+	for (auto& task : m_tasks) {
+		task->dependents.clear();
+		task->numOfDependencies = 0;
+		if (task->profilerZoneId == -1) {
+			task->profilerZoneId = Profiler::RegisterZone(task->name);
+			task->traceCategoryId = Profiler::GetZones()[task->profilerZoneId].traceCategoryId;
+		}
+	}
+
+	for (size_t j = 0; j < m_tasks.size(); j++) {
+		for (size_t i = 0; i < j; i++) {
+			if (m_tasks[i]->system->ConflictsWith(*m_tasks[j]->system)) {
+				m_tasks[i]->dependents.push_back(static_cast<int>(j));
+				m_tasks[j]->numOfDependencies++;
+			}
+		}
+	}
+
+	m_isGraphDirty = false;
+}
+
+void SystemScheduler::RunTask(int taskIndex, double deltaTime) {
+	auto& task = *m_tasks[taskIndex];
+
+	Logger::Trace(task.traceCategoryId, TRACE_BEGIN);
+	const auto startTime = std::chrono::high_resolution_clock::now();
+	task.update(deltaTime);
+	task.lastMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	Logger::Trace(task.traceCategoryId, TRACE_END);
+}
+
+void SystemScheduler::SubmitTask(int taskIndex, double deltaTime) {
+	m_jobSystem.Submit([this, taskIndex, deltaTime]() {
+		RunTask(taskIndex, deltaTime);
+
+		for (int dependentIndex : m_tasks[taskIndex]->dependents) {
+			if (--m_tasks[dependentIndex]->numOfRemainingDependencies == 0) {
+				SubmitTask(dependentIndex, deltaTime);
+			}
+		}
+	});
+}
+
+void SystemScheduler::Run(double deltaTime) {
+	if (m_isGraphDirty) {
+		BuildGraph();
+	}
+
+	if (m_isParallel) {
+		for (auto& task : m_tasks) {
+			task->numOfRemainingDependencies = task->numOfDependencies;
+		}
+		for (size_t i = 0; i < m_tasks.size(); i++) {
+			if (m_tasks[i]->numOfDependencies == 0) {
+				SubmitTask(static_cast<int>(i), deltaTime);
+			}
+		}
+		m_jobSystem.WaitForAll();
+	}
+	else {
+		for (size_t i = 0; i < m_tasks.size(); i++) {
+			RunTask(static_cast<int>(i), deltaTime);
+		}
+	}
+
+	// Profiler zones are only touched from the calling thread
+	for (auto& task : m_tasks) {
+		Profiler::RecordZone(task->profilerZoneId, task->lastMilliseconds);
+	}
+}
@@ -0,0 +1,68 @@
+#ifndef SYSTEMSCHEDULER_H
+#define SYSTEMSCHEDULER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ECS.h"
+#include "../Jobs/JobSystem.h"
+
+// Runs system updates as a dependency graph built from the component
+// read/write sets the systems declare. Two systems conflict when one writes
+// a component the other reads or writes (or either is exclusive); conflicting
+// systems keep the order they were added in, the others run concurrently on
+// the job system. With parallel execution disabled every system runs on the
+// calling thread in insertion order.
+class SystemScheduler {
+	private:
+		struct Task {
+			std::string name;
+			const System* system;
+			std::function<void(double)> update;
+			std::vector<int> dependents;
+			int numOfDependencies;
+			std::atomic<int> numOfRemainingDependencies;
+			int profilerZoneId;
+			uint16_t traceCategoryId;
+			double lastMilliseconds;
+		};
+
+		JobSystem& m_jobSystem;
+		std::vector<std::unique_ptr<Task>> m_tasks;
+		bool m_isParallel = true;
+		bool m_isGraphDirty = false;
+
+		void BuildGraph();
+		void RunTask(int taskIndex, double deltaTime);
+		void SubmitTask(int taskIndex, double deltaTime);
+
+	public:
+		SystemScheduler(JobSystem& jobSystem);
+		~SystemScheduler() = default;
+
+		template <typename TSystem, typename TUpdate> void AddSystem(const std::string& name, TSystem& system, TUpdate update);
+		void Clear();
+
+		void SetParallel(bool isParallel) { m_isParallel = isParallel; }
+		bool IsParallel() const { return m_isParallel; }
+
+		void Run(double deltaTime);
+};
+
+template <typename TSystem, typename TUpdate>
+void SystemScheduler::AddSystem(const std::string& name, TSystem& system, TUpdate update) {
+	auto task = std::make_unique<Task>();
+	task->name = name;
+	task->system = &system;
+	task->update = [&system, update](double deltaTime) { update(system, deltaTime); };
+	task->numOfDependencies = 0;
+	task->numOfRemainingDependencies = 0;
+	task->profilerZoneId = -1;
+	task->lastMilliseconds = 0.0;
+
+	m_tasks.push_back(std::move(task));
+	m_isGraphDirty = true;
+}
+
+#endif
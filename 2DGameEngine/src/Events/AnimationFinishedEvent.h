@@ -0,0 +1,18 @@
+#ifndef ANIMATIONFINISHEDEVENT_H
+#define ANIMATIONFINISHEDEVENT_H
+
+#include "../ECS/ECS.h"
+#include "../EventBus/Event.h"
+
+class AnimationFinishedEvent: public Event {
+    public:
+        Entity entity;
+        int clipId;
+
+        AnimationFinishedEvent(Entity entity, int clipId)
+            : entity(entity), clipId(clipId) {}
+
+        ~AnimationFinishedEvent() = default;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef PROJECTILEFIREDEVENT_H
+#define PROJECTILEFIREDEVENT_H
+
+#include <glm/glm.hpp>
+
+#include "../ECS/ECS.h"
+#include "../EventBus/Event.h"
+
+class ProjectileFiredEvent: public Event {
+    public:
+        Entity emitter;
+        glm::vec2 position;
+
+        ProjectileFiredEvent(Entity emitter, glm::vec2 position)
+            : emitter(emitter), position(position) {}
+
+        ~ProjectileFiredEvent() = default;
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include "FileWatcher.h"
+#include "../Logger/Logger.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher() {
+	m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_inotifyFd < 0) {
+		Logger::Error("Failed to initialize inotify, hot reload is disabled");
+	}
+}
+
+FileWatcher::~FileWatcher() {
+	if (m_inotifyFd >= 0) {
+		close(m_inotifyFd);
+	}
+}
+
+void FileWatcher::Watch(const std::string& filePath) {
+	if (m_inotifyFd < 0 || !m_filePaths.insert(filePath).second) return;
+
+	// Kept as written, empty for the working directory, so the paths rebuilt
+	// from events match the watched ones
+	const std::string directory = std::filesystem::path(filePath).parent_path().string();
+	if (m_watchPerDirectory.count(directory)) return;
+
+	const int watch = inotify_add_watch(m_inotifyFd, directory.empty() ? "." : directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (watch < 0) {
+		Logger::Error("Failed to watch directory: " + directory);
+		return;
+	}
+	m_watchPerDirectory[directory] = watch;
+	m_directoryPerWatch[watch] = directory;
+}
+
+std::vector<std::string> FileWatcher::PollChanges() {
+	std::set<std::string> changedPaths;
+	if (m_inotifyFd < 0) return {};
+
+	alignas(inotify_event) char buffer[4096];
+	while (true) {
+		const ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+		if (length <= 0) {
+			if (length < 0 && errno != EAGAIN) {
+				Logger::Error("Failed to read inotify events");
+			}
+			break;
+		}
+
+		for (ssize_t offset = 0; offset < length;) {
+			const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+
+			const auto directory = m_directoryPerWatch.find(event->wd);
+			if (event->len == 0 || directory == m_directoryPerWatch.end()) continue;
+
+			const std::string filePath = (std::filesystem::path(directory->second) / event->name).string();
+			if (m_filePaths.count(filePath)) {
+				changedPaths.insert(filePath);
+			}
+		}
+	}
+
+	return std::vector<std::string>(changedPaths.begin(), changedPaths.end());
+}
+
+#else
+
+namespace {
+	std::filesystem::file_time_type LastWriteTime(const std::string& filePath) {
+		std::error_code error;
+		const auto time = std::filesystem::last_write_time(filePath, error);
+		return error ? std::filesystem::file_time_type::min() : time;
+	}
+}
+
+FileWatcher::FileWatcher(): m_lastPollTime(std::chrono::steady_clock::now()) {
+}
+
+FileWatcher::~FileWatcher() {
+}
+
+void FileWatcher::Watch(const std::string& filePath) {
+	if (!m_filePaths.insert(filePath).second) return;
+	m_lastWriteTimes[filePath] = LastWriteTime(filePath);
+}
+
+std::vector<std::string> FileWatcher::PollChanges() {
+	std::vector<std::string> changedPaths;
+
+	const auto now = std::chrono::steady_clock::now();
+	if (now - m_lastPollTime < std::chrono::milliseconds(FILE_WATCHER_POLL_INTERVAL_MS)) {
+		return changedPaths;
+	}
+	m_lastPollTime = now;
+
+	for (auto& lastWriteTime : m_lastWriteTimes) {
+		const auto writeTime = LastWriteTime(lastWriteTime.first);
+		if (writeTime != lastWriteTime.second) {
+			lastWriteTime.second = writeTime;
+			changedPaths.push_back(lastWriteTime.first);
+		}
+	}
+
+	return changedPaths;
+}
+
+#endif
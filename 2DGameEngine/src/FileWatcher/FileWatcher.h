@@ -0,0 +1,45 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Reports watched files that changed on disk. PollChanges never blocks and
+// is meant to be called once per frame on the main thread, so whatever
+// reloads the files does it between frames.
+// On Linux this uses inotify on the files' directories, which also catches
+// editors that save by renaming a temporary file over the original. Other
+// platforms compare modification times, at most every
+// FILE_WATCHER_POLL_INTERVAL_MS.
+const int FILE_WATCHER_POLL_INTERVAL_MS = 500;
+
+class FileWatcher {
+	private:
+		// Paths as given to Watch, returned unchanged by PollChanges
+		std::set<std::string> m_filePaths;
+#ifdef __linux__
+		int m_inotifyFd = -1;
+		std::map<int, std::string> m_directoryPerWatch;
+		std::map<std::string, int> m_watchPerDirectory;
+#else
+		std::map<std::string, std::filesystem::file_time_type> m_lastWriteTimes;
+		std::chrono::steady_clock::time_point m_lastPollTime;
+#endif
+
+	public:
+		FileWatcher();
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator =(const FileWatcher&) = delete;
+
+		void Watch(const std::string& filePath);
+		// Each changed path is reported once per call, however many writes it saw
+		std::vector<std::string> PollChanges();
+};
+
+#endif
@@ -1,22 +1,22 @@
 #include <SDL.h>
 #include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
 #include <glm/glm.hpp>
-#include <fstream>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <sstream>
+#include <imgui/imgui.h>
+#include <imgui/imgui_sdl.h>
 
 #include "Game.h"
 #include "../ECS/ECS.h"
 #include "../AssetManager/AssetManager.h"
 #include "../Logger/Logger.h"
-
-#include "../Components/TransformComponent.h"
-#include "../Components/RigidBodyComponent.h"
-#include "../Components/SpriteComponent.h"
-#include "../Components/AnimationComponent.h"
-#include "../Components/BoxColliderComponent.h"
-#include "../Components/KeyboardControlComponent.h"
-#include "../Components/CameraFollowComponent.h"
-#include "../Components/ProjectileEmitterComponent.h"
-#include "../Components/HealthComponent.h"
+#include "../Profiler/Profiler.h"
+#include "../Memory/FrameAllocator.h"
+#include "../LevelLoader/LevelLoader.h"
 
 #include "../Systems/MovementSystem.h"
 #include "../Systems/RenderSystem.h"
@@ -28,6 +28,11 @@
 #include "../Systems/CameraMovementSystem.h"
 #include "../Systems/ProjectileEmitSystem.h"
 #include "../Systems/ProjectileLifeCycleSystem.h"
+#include "../Systems/RenderGUISystem.h"
+#include "../Systems/ScriptSystem.h"
+#include "../Systems/RenderTextSystem.h"
+#include "../Systems/AudioSystem.h"
+#include "../Systems/ParticleSystem.h"
 
 int Game::windowWidth;
 int Game::windowHeight;
@@ -37,9 +42,17 @@ int Game::mapHeight;
 Game::Game() {
     m_isRuning = false;
     m_isDebug = false;
+    m_isHeadless = false;
+    m_window = nullptr;
+    m_renderer = nullptr;
+    m_headlessSurface = nullptr;
     m_registry = std::make_unique<Registry>();
     m_assetManager = std::make_unique<AssetManager>();
     m_eventBus = std::make_unique<EventBus>();
+    m_jobSystem = std::make_unique<JobSystem>();
+    m_systemScheduler = std::make_unique<SystemScheduler>(*m_jobSystem);
+    m_levelLoader = std::make_unique<LevelLoader>();
+    m_registry->SetJobSystem(m_jobSystem.get());
     Logger::Success("Game Constructor Called!");
 }
 
@@ -53,6 +66,19 @@ void Game::Initialize() {
         return;
     }
 
+    if (TTF_Init() != 0) {
+        Logger::Error("Error initializing SDL_ttf");
+        return;
+    }
+
+    // The game still runs without a sound device, sounds are just not loaded
+    if (Mix_OpenAudio(MIX_DEFAULT_FREQUENCY, MIX_DEFAULT_FORMAT, 2, 1024) != 0) {
+        Logger::Warning("Error opening audio, sound is disabled");
+    }
+    else {
+        Mix_AllocateChannels(AUDIO_NUM_CHANNELS);
+    }
+
     SDL_DisplayMode displayMode;
     SDL_GetCurrentDisplayMode(0, &displayMode);
 
@@ -84,6 +110,9 @@ void Game::Initialize() {
         return;
     }
 
+    ImGui::CreateContext();
+    ImGuiSDL::Initialize(m_renderer, windowWidth, windowHeight);
+
     m_camera = { 0, 0, windowWidth, windowHeight };
 
     SDL_SetWindowFullscreen(m_window, SDL_WINDOW_FULLSCREEN);
@@ -91,6 +120,44 @@ void Game::Initialize() {
     m_isRuning = true;
 }
 
+void Game::InitializeHeadless() {
+    // No display is needed: the dummy video driver keeps SDL from opening one
+    // and textures are created by a software renderer on an offscreen surface.
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+
+    // Set before any step can fail, so Destroy takes the headless path
+    m_isHeadless = true;
+
+    if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0) {
+        Logger::Error("Error initializing SDL");
+        return;
+    }
+
+    if (TTF_Init() != 0) {
+        Logger::Error("Error initializing SDL_ttf");
+        return;
+    }
+
+    windowWidth = HEADLESS_WINDOW_WIDTH;
+    windowHeight = HEADLESS_WINDOW_HEIGHT;
+
+    m_headlessSurface = SDL_CreateRGBSurfaceWithFormat(0, windowWidth, windowHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!m_headlessSurface) {
+        Logger::Error("Error creating headless surface.");
+        return;
+    }
+
+    m_renderer = SDL_CreateSoftwareRenderer(m_headlessSurface);
+    if (!m_renderer) {
+        Logger::Error("Error creating SDL software renderer.");
+        return;
+    }
+
+    m_camera = { 0, 0, windowWidth, windowHeight };
+
+    m_isRuning = true;
+}
+
 void Game::LoadLevel(int level) {
     m_registry->AddSystem<MovementSystem>();
     m_registry->AddSystem<RenderSystem>();
@@ -102,104 +169,52 @@ void Game::LoadLevel(int level) {
     m_registry->AddSystem<CameraMovementSystem>();
     m_registry->AddSystem<ProjectileEmitSystem>();
     m_registry->AddSystem<ProjectileLifeCycleSystem>();
-
-    m_assetManager->AddTexture("tank-image", "./assets/images/tank-panther-right.png", m_renderer);
-    m_assetManager->AddTexture("truck-image", "./assets/images/truck-ford-right.png", m_renderer);
-    m_assetManager->AddTexture("chopper-image", "./assets/images/chopper-spritesheet.png", m_renderer);
-    m_assetManager->AddTexture("tilemap-image", "./assets/tilemaps/jungle.png", m_renderer);
-    m_assetManager->AddTexture("bullet-image", "./assets/images/bullet.png", m_renderer);
-
-    int tileSize = 32;
-    double tileScale = 3.0;
-    int mapNumCols = 25;
-    int mapNumRows = 20;
-    std::fstream mapFile;
-    mapFile.open("./assets/tilemaps/jungle.map");
-
-    if (!mapFile.is_open()) {
-        Logger::Error("Failed to open tilemap file: ./assets/tilemaps/jungle.map");
-        return;
-    }
-
-    for (int y = 0; y < mapNumRows; y++) {
-        for (int x = 0; x < mapNumCols; x++) {
-            char ch;
-            mapFile.get(ch);
-            int srcRectY = std::atoi(&ch) * tileSize;
-            mapFile.get(ch);
-            int srcRectX = std::atoi(&ch) * tileSize;
-            mapFile.ignore();
-
-            Entity tile = m_registry->CreateEntity();
-            tile.Group("tiles");
-            tile.AddComponent<TransformComponent>(glm::vec2(x * (tileScale * tileSize), y * (tileScale * tileSize)), glm::vec2(tileScale, tileScale), 0.0);
-            tile.AddComponent<SpriteComponent>("tilemap-image", tileSize, tileSize, 0, false, srcRectX, srcRectY);
-        }
+    m_registry->AddSystem<RenderGUISystem>();
+    m_registry->AddSystem<ScriptSystem>();
+    m_registry->AddSystem<RenderTextSystem>();
+    m_registry->AddSystem<AudioSystem>();
+    m_registry->AddSystem<ParticleSystem>();
+    m_registry->GetSystem<ScriptSystem>().BindAccessors(m_lua, m_registry);
+
+    // Order matters only between systems whose component access conflicts
+    m_systemScheduler->Clear();
+    m_systemScheduler->AddSystem("ScriptSystem", m_registry->GetSystem<ScriptSystem>(), [](ScriptSystem& system, double deltaTime) {
+        system.Update(deltaTime);
+    });
+    m_systemScheduler->AddSystem("MovementSystem", m_registry->GetSystem<MovementSystem>(), [](MovementSystem& system, double deltaTime) {
+        system.Update(deltaTime);
+    });
+    m_systemScheduler->AddSystem("AnimationSystem", m_registry->GetSystem<AnimationSystem>(), [this](AnimationSystem& system, double deltaTime) {
+        system.Update(deltaTime, m_eventBus);
+    });
+    m_systemScheduler->AddSystem("ProjectileLifeCycleSystem", m_registry->GetSystem<ProjectileLifeCycleSystem>(), [](ProjectileLifeCycleSystem& system, double deltaTime) {
+        system.Update(deltaTime);
+    });
+    m_systemScheduler->AddSystem("CollisionSystem", m_registry->GetSystem<CollisionSystem>(), [this](CollisionSystem& system, double deltaTime) {
+        system.Update(m_eventBus);
+    });
+    m_systemScheduler->AddSystem("ProjectileEmitSystem", m_registry->GetSystem<ProjectileEmitSystem>(), [this](ProjectileEmitSystem& system, double deltaTime) {
+        system.Update(m_registry, deltaTime);
+    });
+    m_systemScheduler->AddSystem("ParticleSystem", m_registry->GetSystem<ParticleSystem>(), [](ParticleSystem& system, double deltaTime) {
+        system.Update(deltaTime);
+    });
+
+    if (!m_levelLoader->LoadLevel(m_lua, m_registry, m_assetManager, m_renderer, level)) {
+        Logger::Error("Failed to load level " + std::to_string(level));
     }
-    mapFile.close();
-
-    mapWidth = mapNumCols * tileSize * tileScale;
-    mapHeight = mapNumRows * tileSize * tileScale;
-
-    Entity tank = m_registry->CreateEntity();
-    tank.Group("enemies");
-    tank.AddComponent<TransformComponent>(glm::vec2(340.0, 10.0), glm::vec2(1.0, 1.0), 0.0);
-    tank.AddComponent<RigidBodyComponent>(glm::vec2(30.0, 0.0));
-    tank.AddComponent<SpriteComponent>("tank-image", 32, 32, 1, true);
-    tank.AddComponent<BoxColliderComponent>(32, 32);
-    tank.AddComponent<HealthComponent>(100);
-    tank.AddComponent<CameraFollowComponent>();
-    tank.AddComponent<ProjectileEmitterComponent>(
-        glm::vec2(100.0, 100.0),
-        500,
-        1000,
-        0,
-        false
-    );
-
-    Entity truck = m_registry->CreateEntity();
-    truck.Group("enemies");
-    truck.AddComponent<TransformComponent>(glm::vec2(500.0, 10.0), glm::vec2(1.0, 1.0), 0.0);
-    truck.AddComponent<RigidBodyComponent>(glm::vec2(0.0, 0.0));
-    truck.AddComponent<SpriteComponent>("truck-image", 32, 32, 2);
-    truck.AddComponent<BoxColliderComponent>(32, 32);
-    truck.AddComponent<HealthComponent>(100);
-    truck.AddComponent<ProjectileEmitterComponent>(
-        glm::vec2(100.0, 0.0),
-        500,
-        10000,
-        0,
-        false
-    );
-
-    Entity chopper = m_registry->CreateEntity();
-    chopper.Tag("player");
-    chopper.AddComponent<TransformComponent>(glm::vec2(10.0, 100.0), glm::vec2(1.0, 1.0), 0.0);
-    chopper.AddComponent<RigidBodyComponent>(glm::vec2(0.0, 0.0));
-    chopper.AddComponent<SpriteComponent>("chopper-image", 32, 32, 3);
-    chopper.AddComponent<AnimationComponent>(2, 12, true);
-    chopper.AddComponent<BoxColliderComponent>(32, 32);
-    chopper.AddComponent<CameraFollowComponent>();
-    chopper.AddComponent<HealthComponent>(100);
-    chopper.AddComponent<KeyboardControlComponent>(
-        glm::vec2(0, -100),
-        glm::vec2(100, 0),
-        glm::vec2(0, 100),
-        glm::vec2(-100, 0)
-    );
-    chopper.AddComponent<ProjectileEmitterComponent>(
-        glm::vec2(150.0, 150.0),
-        0,
-        10000,
-        0,
-        true
-    );
-
 }
 
 void Game::ProcessInput() {
     SDL_Event sdlEvent;
     while (SDL_PollEvent(&sdlEvent)) {
+        ImGuiIO& io = ImGui::GetIO();
+        int mouseX, mouseY;
+        const int buttons = SDL_GetMouseState(&mouseX, &mouseY);
+        io.MousePos = ImVec2(mouseX, mouseY);
+        io.MouseDown[0] = buttons & SDL_BUTTON(SDL_BUTTON_LEFT);
+        io.MouseDown[1] = buttons & SDL_BUTTON(SDL_BUTTON_RIGHT);
+
         switch (sdlEvent.type) {
             case SDL_QUIT:
                 m_isRuning = false;
@@ -211,52 +226,197 @@ void Game::ProcessInput() {
                 if (sdlEvent.key.keysym.sym == SDLK_d) {
                     m_isDebug = !m_isDebug;
                 }
-                m_eventBus->EmitEvent<KeyPressedEvent>(sdlEvent.key.keysym.sym);
+                // Live gameplay keys are ignored while a replay drives the game
+                if (sdlEvent.key.keysym.sym != SDLK_ESCAPE && sdlEvent.key.keysym.sym != SDLK_d && !m_inputReplay.IsOpen()) {
+                    m_pendingKeys.push_back(sdlEvent.key.keysym.sym);
+                }
                 break;
         }
     }
 }
 
+void Game::WatchSourceFiles() {
+    m_fileWatcher = std::make_unique<FileWatcher>();
+    for (const auto& filePath : m_assetManager->GetTextureFilePaths()) {
+        m_fileWatcher->Watch(filePath);
+    }
+    for (const auto& filePath : m_levelLoader->GetSourceFilePaths()) {
+        m_fileWatcher->Watch(filePath);
+    }
+}
+
+// Runs before the frame's fixed steps, so systems and the renderer only ever
+// see the old or the new version of an asset
+void Game::ReloadChangedFiles() {
+    if (!m_fileWatcher) return;
+
+    for (const auto& filePath : m_fileWatcher->PollChanges()) {
+        const bool isTexture = m_assetManager->ReloadTexturesFromFile(filePath, m_renderer);
+        const bool isLevelSource = m_levelLoader->ReloadFile(filePath, m_lua, m_registry);
+        if (!isTexture && !isLevelSource) {
+            Logger::Warning("Changed file is not used by the level: " + filePath);
+        }
+    }
+}
+
+void Game::HandleKey(int32_t key) {
+    if (key == SDLK_r) {
+        LoadSnapshot(m_levelSnapshot);
+    }
+    if (key == SDLK_F5) {
+        SaveSnapshot(m_quickSnapshot);
+    }
+    if (key == SDLK_F9) {
+        LoadSnapshot(m_quickSnapshot);
+    }
+    m_eventBus->EmitEvent<KeyPressedEvent>(key);
+}
+
+void Game::ApplyInput() {
+    if (m_inputReplay.IsOpen()) {
+        m_inputReplay.ReadStep(m_simulationStep, m_pendingKeys);
+    }
+
+    for (int32_t key : m_pendingKeys) {
+        m_inputRecorder.Record(m_simulationStep, key);
+        HandleKey(key);
+    }
+    m_pendingKeys.clear();
+}
+
+bool Game::StartInputRecording(const std::string& filePath) {
+    return m_inputRecorder.Open(filePath);
+}
+
+bool Game::StartInputReplay(const std::string& filePath) {
+    return m_inputReplay.Open(filePath);
+}
+
+void Game::SetDeterministic(bool isDeterministic) {
+    m_systemScheduler->SetParallel(!isDeterministic);
+    m_registry->SetJobSystem(isDeterministic ? nullptr : m_jobSystem.get());
+}
+
+void Game::SaveSnapshot(std::string& snapshot) {
+    std::ostringstream stream(std::ios::binary);
+    m_registry->SaveSnapshot(stream);
+    snapshot = stream.str();
+}
+
+void Game::LoadSnapshot(const std::string& snapshot) {
+    if (snapshot.empty()) return;
+
+    std::istringstream stream(snapshot, std::ios::binary);
+    if (m_registry->LoadSnapshot(stream)) {
+        // Pooled projectile handles from before the load are dead now
+        m_registry->GetSystem<ProjectileEmitSystem>().ClearProjectilePools();
+        // The systems see the restored entities after an Update
+        m_registry->Update();
+        m_registry->GetSystem<ProjectileLifeCycleSystem>().ReleasePooledProjectiles();
+        // Particles are not part of the snapshot, drop the ones from before it
+        m_registry->GetSystem<ParticleSystem>().Clear();
+    }
+}
+
 void Game::Setup() {
+    m_lua.open_libraries(sol::lib::base, sol::lib::math);
     LoadLevel(1);
+    SaveSnapshot(m_levelSnapshot);
+
+    m_previousCounter = SDL_GetPerformanceCounter();
+    m_accumulator = 0.0;
+    m_simulationStep = 0;
+    m_pendingKeys.clear();
 }
 
 void Game::Update() {
-    int timeToWait = MILLISECONDS_PER_FRAME - (SDL_GetTicks() - m_millisecondsPreviuosFrame);
+    FrameAllocator::Reset();
+    ReloadChangedFiles();
+
+    const Uint64 currentCounter = SDL_GetPerformanceCounter();
+    m_accumulator += static_cast<double>(currentCounter - m_previousCounter) / SDL_GetPerformanceFrequency();
+    m_previousCounter = currentCounter;
+
+    // Run as many fixed steps as the elapsed time asks for, under load this
+    // means several steps per rendered frame
+    int numOfSteps = 0;
+    while (m_accumulator >= FIXED_DELTA_TIME && numOfSteps < MAX_SIMULATION_STEPS_PER_FRAME) {
+        UpdateSystems(FIXED_DELTA_TIME);
+        m_accumulator -= FIXED_DELTA_TIME;
+        numOfSteps++;
+    }
 
-    if (timeToWait > 0 && timeToWait <= MILLISECONDS_PER_FRAME) {
-        SDL_Delay(timeToWait);
+    // Too far behind to catch up, drop the backlog instead of spiralling
+    if (m_accumulator >= FIXED_DELTA_TIME) {
+        m_accumulator = 0.0;
     }
 
-    double deltaTime = (SDL_GetTicks() - m_millisecondsPreviuosFrame) / 1000.0;
+    {
+        PROFILE_SCOPE("AudioSystem");
+        m_registry->GetSystem<AudioSystem>().Update(m_assetManager, m_camera);
+    }
+}
 
-    m_millisecondsPreviuosFrame = SDL_GetTicks();
+void Game::UpdateSystems(double deltaTime) {
+    PROFILE_SCOPE("Update");
 
     m_eventBus->Reset();
 
     m_registry->GetSystem<DamageSystem>().SubscribeToEvents(m_eventBus);
     m_registry->GetSystem<KeyboardControlSystem>().SubscribeToEvents(m_eventBus);
     m_registry->GetSystem<ProjectileEmitSystem>().SubscribeToEvents(m_eventBus);
+    m_registry->GetSystem<AudioSystem>().SubscribeToEvents(m_eventBus);
+    m_registry->GetSystem<ParticleSystem>().SubscribeToEvents(m_eventBus);
+
+    ApplyInput();
 
     // update the registry to process entities that are waiting to be created/deleted
-    m_registry->Update();
+    {
+        PROFILE_SCOPE("Registry");
+        m_registry->Update();
+    }
 
     // update all the systems
-    m_registry->GetSystem<MovementSystem>().Update(deltaTime);
-    m_registry->GetSystem<AnimationSystem>().Update();
-    m_registry->GetSystem<CollisionSystem>().Update(m_eventBus);
-    m_registry->GetSystem<CameraMovementSystem>().Update(m_camera);
-    m_registry->GetSystem<ProjectileEmitSystem>().Update(m_registry);
-    m_registry->GetSystem<ProjectileLifeCycleSystem>().Update();
+    m_systemScheduler->Run(deltaTime);
+
+    m_simulationStep++;
 }
 
 void Game::Render() {
-    SDL_SetRenderDrawColor(m_renderer, 21, 21, 21, 255);
-    SDL_RenderClear(m_renderer);
+    // How far we are between the last two simulation steps
+    const double alpha = m_accumulator / FIXED_DELTA_TIME;
+
+    {
+        PROFILE_SCOPE("Render");
+
+        {
+            PROFILE_SCOPE("CameraMovementSystem");
+            m_registry->GetSystem<CameraMovementSystem>().Update(m_camera, alpha);
+        }
+
+        SDL_SetRenderDrawColor(m_renderer, 21, 21, 21, 255);
+        SDL_RenderClear(m_renderer);
+
+        {
+            PROFILE_SCOPE("RenderSystem");
+            m_registry->GetSystem<RenderSystem>().Update(m_renderer, m_assetManager, m_camera, alpha);
+        }
+        {
+            PROFILE_SCOPE("ParticleSystem");
+            m_registry->GetSystem<ParticleSystem>().Render(m_renderer, m_camera);
+        }
+        {
+            PROFILE_SCOPE("RenderTextSystem");
+            m_registry->GetSystem<RenderTextSystem>().Update(m_renderer, m_assetManager, m_camera);
+        }
+        if (m_isDebug) {
+            PROFILE_SCOPE("RenderColliderSystem");
+            m_registry->GetSystem<RenderColliderSystem>().Update(m_renderer, m_camera, alpha);
+        }
+    }
 
-    m_registry->GetSystem<RenderSystem>().Update(m_renderer, m_assetManager, m_camera);
     if (m_isDebug) {
-        m_registry->GetSystem<RenderColliderSystem>().Update(m_renderer, m_camera);
+        m_registry->GetSystem<RenderGUISystem>().Update();
     }
 
     SDL_RenderPresent(m_renderer);
@@ -264,15 +424,96 @@ void Game::Render() {
 
 void Game::Run() {
     Setup();
+    WatchSourceFiles();
     while (m_isRuning) {
+        Profiler::BeginFrame();
         ProcessInput();
         Update();
         Render();
+        Profiler::EndFrame();
+    }
+}
+
+void Game::RunHeadless(int numOfFrames) {
+    Setup();
+
+    if (!m_isRuning) {
+        Logger::Error("Headless run aborted, the game was not initialized");
+        return;
+    }
+
+    // Without an explicit frame count a replay runs until its last input
+    if (numOfFrames <= 0 && m_inputReplay.IsOpen()) {
+        numOfFrames = static_cast<int>(m_inputReplay.GetLastStep()) + 1;
+    }
+
+    typedef std::chrono::high_resolution_clock Clock;
+    double totalMilliseconds = 0.0;
+    double minFrameMilliseconds = std::numeric_limits<double>::max();
+    double maxFrameMilliseconds = 0.0;
+
+    for (int frame = 0; frame < numOfFrames; frame++) {
+        const auto frameStartTime = Clock::now();
+
+        Profiler::BeginFrame();
+        FrameAllocator::Reset();
+        UpdateSystems(FIXED_DELTA_TIME);
+        Profiler::EndFrame();
+
+        const double frameMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - frameStartTime).count();
+        totalMilliseconds += frameMilliseconds;
+        minFrameMilliseconds = std::min(minFrameMilliseconds, frameMilliseconds);
+        maxFrameMilliseconds = std::max(maxFrameMilliseconds, frameMilliseconds);
+    }
+
+    if (numOfFrames <= 0) return;
+
+    const double averageFrameMilliseconds = totalMilliseconds / numOfFrames;
+    Logger::Success(
+        "Headless run: frames=" + std::to_string(numOfFrames) +
+        " total_ms=" + std::to_string(totalMilliseconds) +
+        " avg_ms=" + std::to_string(averageFrameMilliseconds) +
+        " min_ms=" + std::to_string(minFrameMilliseconds) +
+        " max_ms=" + std::to_string(maxFrameMilliseconds) +
+        " fps=" + std::to_string(1000.0 / averageFrameMilliseconds) +
+        " frame_alloc_peak_bytes=" + std::to_string(FrameAllocator::GetPeakFrameBytes())
+    );
+    for (const auto& zone : Profiler::GetZones()) {
+        Logger::Info(
+            "Headless zone: name=" + zone.name +
+            " avg_ms=" + std::to_string(zone.GetAverage()) +
+            " min_ms=" + std::to_string(zone.GetMin()) +
+            " max_ms=" + std::to_string(zone.GetMax())
+        );
     }
 }
 
 void Game::Destroy() {
-    SDL_DestroyRenderer(m_renderer);
-    SDL_DestroyWindow(m_window);
+    m_inputRecorder.Close();
+    m_inputReplay.Close();
+
+    // Textures, atlases and sounds go before their renderer and audio device
+    m_assetManager->ClearAssets();
+
+    // Initialization may have stopped at any step, only what was created is
+    // destroyed. TTF_Quit, Mix_CloseAudio and SDL_Quit do nothing when their
+    // init failed.
+    if (m_isHeadless) {
+        if (m_renderer) SDL_DestroyRenderer(m_renderer);
+        if (m_headlessSurface) SDL_FreeSurface(m_headlessSurface);
+        TTF_Quit();
+        SDL_Quit();
+        return;
+    }
+
+    // The ImGui context and ImGuiSDL are created together, after the renderer
+    if (ImGui::GetCurrentContext()) {
+        ImGuiSDL::Deinitialize();
+        ImGui::DestroyContext();
+    }
+    if (m_renderer) SDL_DestroyRenderer(m_renderer);
+    if (m_window) SDL_DestroyWindow(m_window);
+    Mix_CloseAudio();
+    TTF_Quit();
     SDL_Quit();
 }
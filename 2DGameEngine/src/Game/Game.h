@@ -2,39 +2,83 @@
 #define GAME_H
 
 #include <SDL.h>
+#include <string>
+#include <sol/sol.hpp>
 
 #include "../ECS/ECS.h"
 #include "../AssetManager/AssetManager.h"
 #include "../EventBus/EventBus.h"
+#include "../ECS/SystemScheduler.h"
+#include "../Jobs/JobSystem.h"
+#include "../Input/InputRecording.h"
+#include "../LevelLoader/LevelLoader.h"
+#include "../FileWatcher/FileWatcher.h"
 
 const int FPS = 60;
-const int MILLISECONDS_PER_FRAME = 1000 / FPS;
+const double FIXED_DELTA_TIME = 1.0 / FPS;
+const int MAX_SIMULATION_STEPS_PER_FRAME = 5;
+const int HEADLESS_WINDOW_WIDTH = 1280;
+const int HEADLESS_WINDOW_HEIGHT = 720;
 
 class Game {
 	private:
 		bool m_isRuning;
 		bool m_isDebug;
-		int m_millisecondsPreviuosFrame = 0;
+		bool m_isHeadless;
+		Uint64 m_previousCounter = 0;
+		double m_accumulator = 0.0;
 		SDL_Window* m_window;
 		SDL_Renderer* m_renderer;
+		SDL_Surface* m_headlessSurface;
 		SDL_Rect m_camera;
 
 		std::unique_ptr<Registry> m_registry;
 		std::unique_ptr<AssetManager> m_assetManager;
 		std::unique_ptr<EventBus> m_eventBus;
+		std::unique_ptr<JobSystem> m_jobSystem;
+		std::unique_ptr<SystemScheduler> m_systemScheduler;
+		sol::state m_lua;
+		std::unique_ptr<LevelLoader> m_levelLoader;
+		// Only created for interactive runs, headless runs never reload
+		std::unique_ptr<FileWatcher> m_fileWatcher;
+
+		// Registry snapshots: the level right after loading (restart) and the
+		// last quick save
+		std::string m_levelSnapshot;
+		std::string m_quickSnapshot;
+
+		// Keys are applied at the start of a fixed step rather than when they
+		// are polled, so a recording can replay them at the same step
+		uint64_t m_simulationStep = 0;
+		std::vector<int32_t> m_pendingKeys;
+		InputRecorder m_inputRecorder;
+		InputReplay m_inputReplay;
+
+		void WatchSourceFiles();
+		void ReloadChangedFiles();
+		void ApplyInput();
+		void HandleKey(int32_t key);
 
 	public:
 		Game();
 		~Game();
 
 		void Initialize();
+		void InitializeHeadless();
 		void Run();
+		void RunHeadless(int numOfFrames);
 		void Setup();
 		void ProcessInput();
 		void Update();
+		void UpdateSystems(double deltaTime);
 		void Render();
 		void Destroy();
 		void LoadLevel(int level);
+		void SetDeterministic(bool isDeterministic);
+		void SaveSnapshot(std::string& snapshot);
+		void LoadSnapshot(const std::string& snapshot);
+		bool StartInputRecording(const std::string& filePath);
+		bool StartInputReplay(const std::string& filePath);
 
 		static int windowWidth;
 		static int windowHeight;
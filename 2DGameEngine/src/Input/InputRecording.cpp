@@ -0,0 +1,82 @@
+#include "InputRecording.h"
+#include "../Logger/Logger.h"
+
+bool InputRecorder::Open(const std::string& filePath) {
+	if (m_file.is_open()) {
+		Logger::Warning("Input is already being recorded, ignoring: " + filePath);
+		return false;
+	}
+
+	m_file.open(filePath, std::ios::binary | std::ios::trunc);
+	if (!m_file.is_open()) {
+		Logger::Error("Failed to open input recording: " + filePath);
+		return false;
+	}
+
+	InputRecordingHeader header = { INPUT_RECORDING_MAGIC, INPUT_RECORDING_VERSION };
+	m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	m_numOfRecords = 0;
+
+	Logger::Info("Recording input to " + filePath);
+	return true;
+}
+
+void InputRecorder::Record(uint64_t step, int32_t key) {
+	if (!m_file.is_open()) return;
+
+	InputRecord record = { step, key, 0 };
+	m_file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+	m_numOfRecords++;
+}
+
+void InputRecorder::Close() {
+	if (!m_file.is_open()) return;
+
+	m_file.close();
+	Logger::Info("Input recording closed, records=" + std::to_string(m_numOfRecords));
+}
+
+bool InputReplay::Open(const std::string& filePath) {
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file.is_open()) {
+		Logger::Error("Failed to open input replay: " + filePath);
+		return false;
+	}
+
+	InputRecordingHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		header.magic != INPUT_RECORDING_MAGIC || header.version != INPUT_RECORDING_VERSION) {
+		Logger::Error("Not a valid input recording: " + filePath);
+		return false;
+	}
+
+	// The file is small, load it whole so replay never touches the disk mid-run
+	m_records.clear();
+	InputRecord record;
+	while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+		if (!m_records.empty() && record.step < m_records.back().step) {
+			Logger::Error("Input recording is not sorted by step: " + filePath);
+			m_records.clear();
+			return false;
+		}
+		m_records.push_back(record);
+	}
+
+	m_nextRecord = 0;
+	m_isOpen = true;
+	Logger::Info("Replaying input from " + filePath + ", records=" + std::to_string(m_records.size()));
+	return true;
+}
+
+void InputReplay::ReadStep(uint64_t step, std::vector<int32_t>& keys) {
+	while (m_nextRecord < m_records.size() && m_records[m_nextRecord].step <= step) {
+		keys.push_back(m_records[m_nextRecord].key);
+		m_nextRecord++;
+	}
+}
+
+void InputReplay::Close() {
+	m_records.clear();
+	m_nextRecord = 0;
+	m_isOpen = false;
+}
@@ -0,0 +1,59 @@
+#ifndef INPUTRECORDING_H
+#define INPUTRECORDING_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+
+// On-disk layout of an input recording: an InputRecordingHeader followed by
+// InputRecords sorted by simulation step. A step is one fixed update of
+// Game::UpdateSystems, counted from the end of Game::Setup, so replaying the
+// records at the same steps reproduces the session independent of wall time.
+
+const uint32_t INPUT_RECORDING_MAGIC = 0x4E504932; // "2IPN"
+const uint32_t INPUT_RECORDING_VERSION = 1;
+
+struct InputRecordingHeader {
+	uint32_t magic;
+	uint32_t version;
+};
+
+struct InputRecord {
+	uint64_t step;
+	int32_t key;
+	uint32_t reserved;
+};
+
+static_assert(sizeof(InputRecordingHeader) == 8, "InputRecordingHeader must be 8 bytes");
+static_assert(sizeof(InputRecord) == 16, "InputRecord must be 16 bytes");
+
+class InputRecorder {
+	private:
+		std::ofstream m_file;
+		size_t m_numOfRecords = 0;
+
+	public:
+		bool Open(const std::string& filePath);
+		void Record(uint64_t step, int32_t key);
+		void Close();
+		bool IsOpen() const { return m_file.is_open(); }
+};
+
+class InputReplay {
+	private:
+		std::vector<InputRecord> m_records;
+		size_t m_nextRecord = 0;
+		bool m_isOpen = false;
+
+	public:
+		bool Open(const std::string& filePath);
+		// Appends the keys recorded up to and including `step` to `keys`
+		void ReadStep(uint64_t step, std::vector<int32_t>& keys);
+		void Close();
+		bool IsOpen() const { return m_isOpen; }
+		bool IsFinished() const { return m_nextRecord >= m_records.size(); }
+		uint64_t GetLastStep() const { return m_records.empty() ? 0 : m_records.back().step; }
+};
+
+#endif
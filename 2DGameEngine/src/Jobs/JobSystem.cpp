@@ -0,0 +1,138 @@
+#include "JobSystem.h"
+#include "../Logger/Logger.h"
+
+namespace {
+	// Which job system the current thread works for and the index of its deque
+	thread_local const JobSystem* currentJobSystem = nullptr;
+	thread_local unsigned int currentQueueIndex = 0;
+}
+
+unsigned int JobSystem::GetDefaultNumOfWorkers() {
+	// hardware_concurrency reports 0 when it cannot tell
+	const unsigned int numOfThreads = std::thread::hardware_concurrency();
+	return numOfThreads > 1 ? numOfThreads - 1 : 0;
+}
+
+JobSystem::JobSystem(unsigned int numOfWorkers): m_numOfQueuedJobs(0), m_numOfPendingJobs(0), m_isRunning(true) {
+	numOfWorkers = std::min(numOfWorkers, MAX_JOB_WORKERS);
+
+	for (unsigned int i = 0; i < numOfWorkers + 1; i++) {
+		m_queues.push_back(std::make_unique<WorkQueue>());
+	}
+
+	for (unsigned int i = 0; i < numOfWorkers; i++) {
+		m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+
+	Logger::Info("Job System created with " + std::to_string(numOfWorkers) + " worker threads");
+}
+
+JobSystem::~JobSystem() {
+	m_isRunning = false;
+	WakeUp();
+
+	for (auto& worker : m_workers) {
+		worker.join();
+	}
+}
+
+unsigned int JobSystem::GetQueueIndex() const {
+	return currentJobSystem == this ? currentQueueIndex : static_cast<unsigned int>(m_workers.size());
+}
+
+void JobSystem::Push(std::function<void()> function, std::atomic<int>* counter) {
+	if (counter) {
+		(*counter)++;
+	}
+	m_numOfPendingJobs++;
+
+	auto& queue = *m_queues[GetQueueIndex()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back({ std::move(function), counter });
+	}
+	m_numOfQueuedJobs++;
+}
+
+void JobSystem::WakeUp() {
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+	m_condition.notify_all();
+}
+
+void JobSystem::Submit(std::function<void()> job, std::atomic<int>* counter) {
+	Push(std::move(job), counter);
+	WakeUp();
+}
+
+bool JobSystem::TryRunJob(unsigned int queueIndex) {
+	Job job;
+	bool hasJob = false;
+
+	// Own deque first, newest job first
+	{
+		auto& queue = *m_queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+			hasJob = true;
+		}
+	}
+
+	// Then steal the oldest job from someone else
+	for (size_t i = 1; !hasJob && i < m_queues.size(); i++) {
+		auto& queue = *m_queues[(queueIndex + i) % m_queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			hasJob = true;
+		}
+	}
+
+	if (!hasJob) return false;
+
+	m_numOfQueuedJobs--;
+	job.function();
+
+	bool isWaitOver = false;
+	if (job.counter && --(*job.counter) == 0) {
+		isWaitOver = true;
+	}
+	if (--m_numOfPendingJobs == 0) {
+		isWaitOver = true;
+	}
+	if (isWaitOver) {
+		WakeUp();
+	}
+	return true;
+}
+
+void JobSystem::Wait(std::atomic<int>& counter) {
+	const unsigned int queueIndex = GetQueueIndex();
+
+	while (counter > 0) {
+		if (TryRunJob(queueIndex)) continue;
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_condition.wait(lock, [this, &counter]() { return counter == 0 || m_numOfQueuedJobs > 0; });
+	}
+}
+
+void JobSystem::WaitForAll() {
+	Wait(m_numOfPendingJobs);
+}
+
+void JobSystem::WorkerLoop(unsigned int workerIndex) {
+	currentJobSystem = this;
+	currentQueueIndex = workerIndex;
+
+	while (m_isRunning) {
+		if (TryRunJob(workerIndex)) continue;
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_condition.wait(lock, [this]() { return !m_isRunning || m_numOfQueuedJobs > 0; });
+	}
+}
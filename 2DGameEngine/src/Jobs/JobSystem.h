@@ -0,0 +1,89 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Workers past this are not started, the deques are scanned on every steal
+const unsigned int MAX_JOB_WORKERS = 63;
+
+// Work-stealing job system. Every worker owns a deque: it pushes and pops its
+// own jobs at the back and, when empty, steals from the front of the others.
+// Threads that are not workers (the main thread) share one extra deque.
+// Any thread waiting on jobs helps running them instead of blocking.
+class JobSystem {
+	private:
+		struct Job {
+			std::function<void()> function;
+			std::atomic<int>* counter;
+		};
+
+		struct WorkQueue {
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		std::vector<std::thread> m_workers;
+		std::vector<std::unique_ptr<WorkQueue>> m_queues;
+		std::mutex m_sleepMutex;
+		std::condition_variable m_condition;
+		std::atomic<int> m_numOfQueuedJobs;
+		std::atomic<int> m_numOfPendingJobs;
+		std::atomic<bool> m_isRunning;
+
+		unsigned int GetQueueIndex() const;
+		void Push(std::function<void()> function, std::atomic<int>* counter);
+		void WakeUp();
+		bool TryRunJob(unsigned int queueIndex);
+		void WorkerLoop(unsigned int workerIndex);
+
+	public:
+		// One worker per hardware thread besides the calling one, none when
+		// the hardware thread count is unknown
+		static unsigned int GetDefaultNumOfWorkers();
+
+		JobSystem(unsigned int numOfWorkers = GetDefaultNumOfWorkers());
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator =(const JobSystem&) = delete;
+
+		unsigned int GetNumOfWorkers() const { return static_cast<unsigned int>(m_workers.size()); }
+
+		// counter, when given, is incremented now and decremented when the job is done
+		void Submit(std::function<void()> job, std::atomic<int>* counter = nullptr);
+		void Wait(std::atomic<int>& counter);
+		void WaitForAll();
+
+		// Calls func(begin, end) over [0, count) split in chunks of grainSize
+		template <typename TFunc> void ParallelFor(size_t count, size_t grainSize, TFunc func);
+};
+
+template <typename TFunc>
+void JobSystem::ParallelFor(size_t count, size_t grainSize, TFunc func) {
+	grainSize = std::max<size_t>(grainSize, 1);
+
+	if (count <= grainSize || m_workers.empty()) {
+		if (count > 0) func(size_t(0), count);
+		return;
+	}
+
+	std::atomic<int> counter(0);
+	for (size_t begin = grainSize; begin < count; begin += grainSize) {
+		const size_t end = std::min(begin + grainSize, count);
+		Push([&func, begin, end]() { func(begin, end); }, &counter);
+	}
+	WakeUp();
+
+	func(size_t(0), grainSize);
+	Wait(counter);
+}
+
+#endif
@@ -0,0 +1,456 @@
+#include <fstream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "LevelLoader.h"
+#include "../ECS/Prefab.h"
+#include "../Game/Game.h"
+#include "../Logger/Logger.h"
+#include "../Animation/AnimationClips.h"
+
+#include "../Components/TransformComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../Components/SpriteComponent.h"
+#include "../Components/AnimationComponent.h"
+#include "../Components/BoxColliderComponent.h"
+#include "../Components/KeyboardControlComponent.h"
+#include "../Components/CameraFollowComponent.h"
+#include "../Components/ProjectileEmitterComponent.h"
+#include "../Components/HealthComponent.h"
+#include "../Components/ScriptComponent.h"
+#include "../Components/TextLabelComponent.h"
+#include "../Components/ParticleEmitterComponent.h"
+
+#include "../Systems/ScriptSystem.h"
+#include "../Systems/AudioSystem.h"
+
+namespace {
+	glm::vec2 ReadVec2(const sol::table& table, const char* key, const glm::vec2& fallback = glm::vec2(0)) {
+		sol::optional<sol::table> vector = table[key];
+		if (!vector) return fallback;
+		return glm::vec2(vector->get_or<double>("x", fallback.x), vector->get_or<double>("y", fallback.y));
+	}
+
+	SDL_Color ReadColor(const sol::table& table, const char* key, const SDL_Color& fallback) {
+		sol::optional<sol::table> color = table[key];
+		if (!color) return fallback;
+		return {
+			static_cast<Uint8>(color->get_or("r", static_cast<int>(fallback.r))),
+			static_cast<Uint8>(color->get_or("g", static_cast<int>(fallback.g))),
+			static_cast<Uint8>(color->get_or("b", static_cast<int>(fallback.b))),
+			static_cast<Uint8>(color->get_or("a", static_cast<int>(fallback.a)))
+		};
+	}
+
+	// Source rect position of every tile, row by row, from a map file of
+	// two-digit "rowcol" atlas indices
+	bool ReadTilemapFile(const std::string& mapFilePath, int numRows, int numCols, int tileSize, std::vector<SDL_Point>& srcRectPositions) {
+		std::fstream mapFile;
+		mapFile.open(mapFilePath);
+
+		if (!mapFile.is_open()) {
+			Logger::Error("Failed to open tilemap file: " + mapFilePath);
+			return false;
+		}
+
+		srcRectPositions.clear();
+		srcRectPositions.reserve(numRows * numCols);
+		for (int y = 0; y < numRows; y++) {
+			for (int x = 0; x < numCols; x++) {
+				char ch;
+				mapFile.get(ch);
+				int srcRectY = std::atoi(&ch) * tileSize;
+				mapFile.get(ch);
+				int srcRectX = std::atoi(&ch) * tileSize;
+				mapFile.ignore();
+
+				srcRectPositions.push_back({ srcRectX, srcRectY });
+			}
+		}
+		mapFile.close();
+		return true;
+	}
+
+	AnimationPlayback ReadPlayback(const std::string& playback) {
+		if (playback == "once") return ANIMATION_ONCE;
+		if (playback == "ping_pong") return ANIMATION_PING_PONG;
+		return ANIMATION_LOOP;
+	}
+
+	// Reads every component of an entity table once into a prefab
+	void ReadPrefab(const sol::table& components, const ScriptSystem& scriptSystem, Prefab& prefab) {
+		if (sol::optional<sol::table> transform = components["transform"]) {
+			prefab.AddComponent<TransformComponent>(
+				ReadVec2(*transform, "position"),
+				ReadVec2(*transform, "scale", glm::vec2(1, 1)),
+				transform->get_or("rotation", 0.0)
+			);
+		}
+		if (sol::optional<sol::table> rigidBody = components["rigidbody"]) {
+			prefab.AddComponent<RigidBodyComponent>(ReadVec2(*rigidBody, "velocity"));
+		}
+		if (sol::optional<sol::table> sprite = components["sprite"]) {
+			prefab.AddComponent<SpriteComponent>(
+				sprite->get_or<std::string>("texture_asset_id", ""),
+				sprite->get_or("width", 0),
+				sprite->get_or("height", 0),
+				sprite->get_or("z_index", 0),
+				sprite->get_or("fixed", false),
+				sprite->get_or("src_rect_x", 0),
+				sprite->get_or("src_rect_y", 0)
+			);
+		}
+		if (sol::optional<sol::table> animation = components["animation"]) {
+			// A named clip from animation_clips, or a uniform strip of frames
+			int clipId = -1;
+			if (sol::optional<std::string> clipName = (*animation)["clip"]) {
+				clipId = AnimationClips::GetClipId(*clipName);
+				if (clipId < 0) {
+					Logger::Warning("Unknown animation clip '" + *clipName + "'");
+				}
+			}
+			else {
+				clipId = AnimationClips::AddUniformClip(
+					animation->get_or("num_frames", 1),
+					animation->get_or("speed_rate", 1),
+					animation->get_or("loop", true) ? ANIMATION_LOOP : ANIMATION_ONCE
+				);
+			}
+			prefab.AddComponent<AnimationComponent>(clipId, animation->get_or("time_scale", 1.0f));
+		}
+		if (sol::optional<sol::table> boxCollider = components["boxcollider"]) {
+			prefab.AddComponent<BoxColliderComponent>(
+				boxCollider->get_or("width", 0),
+				boxCollider->get_or("height", 0),
+				ReadVec2(*boxCollider, "offset")
+			);
+		}
+		if (sol::optional<sol::table> health = components["health"]) {
+			prefab.AddComponent<HealthComponent>(health->get_or("health_percentage", 100));
+		}
+		if (sol::optional<sol::table> keyboardController = components["keyboard_controller"]) {
+			prefab.AddComponent<KeyboardControlComponent>(
+				ReadVec2(*keyboardController, "up_velocity"),
+				ReadVec2(*keyboardController, "right_velocity"),
+				ReadVec2(*keyboardController, "down_velocity"),
+				ReadVec2(*keyboardController, "left_velocity")
+			);
+		}
+		if (sol::optional<sol::table> cameraFollow = components["camera_follow"]) {
+			prefab.AddComponent<CameraFollowComponent>();
+		}
+		if (sol::optional<sol::table> projectileEmitter = components["projectile_emitter"]) {
+			prefab.AddComponent<ProjectileEmitterComponent>(
+				ReadVec2(*projectileEmitter, "projectile_velocity"),
+				projectileEmitter->get_or("repeat_frequency", 0),
+				projectileEmitter->get_or("projectile_duration", 10000),
+				projectileEmitter->get_or("hit_percentage_damage", 10),
+				projectileEmitter->get_or("friendly", false),
+				projectileEmitter->get_or("max_projectiles", 0)
+			);
+		}
+		if (sol::optional<sol::table> textLabel = components["text_label"]) {
+			prefab.AddComponent<TextLabelComponent>(
+				ReadVec2(*textLabel, "position"),
+				textLabel->get_or<std::string>("text", ""),
+				textLabel->get_or<std::string>("font_asset_id", ""),
+				ReadColor(*textLabel, "color", { 255, 255, 255, 255 }),
+				textLabel->get_or("fixed", true)
+			);
+		}
+		if (sol::optional<sol::table> particleEmitter = components["particle_emitter"]) {
+			prefab.AddComponent<ParticleEmitterComponent>(
+				particleEmitter->get_or("emission_rate", 0.0f),
+				particleEmitter->get_or("burst_count", 0),
+				particleEmitter->get_or("particle_lifetime", 1.0f),
+				particleEmitter->get_or("min_speed", 10.0f),
+				particleEmitter->get_or("max_speed", 50.0f),
+				particleEmitter->get_or("direction", 0.0f),
+				particleEmitter->get_or("spread", 360.0f),
+				particleEmitter->get_or("particle_size", 2.0f),
+				ReadColor(*particleEmitter, "start_color", { 255, 255, 255, 255 }),
+				ReadColor(*particleEmitter, "end_color", { 255, 255, 255, 0 }),
+				ReadVec2(*particleEmitter, "offset")
+			);
+		}
+		if (sol::optional<sol::table> script = components["script"]) {
+			const std::string name = script->get_or<std::string>("name", "");
+			const int scriptId = scriptSystem.GetScriptId(name);
+			if (scriptId < 0) {
+				Logger::Warning("Unknown script '" + name + "', the component is skipped");
+			}
+			else {
+				prefab.AddComponent<ScriptComponent>(scriptId);
+			}
+		}
+	}
+}
+
+bool LevelLoader::LoadLevel(
+	sol::state& lua,
+	const std::unique_ptr<Registry>& registry,
+	const std::unique_ptr<AssetManager>& assetManager,
+	SDL_Renderer* renderer,
+	int level
+) {
+	m_scriptPath = "./assets/scripts/Level" + std::to_string(level) + ".lua";
+
+	sol::protected_function_result script = lua.safe_script_file(m_scriptPath, sol::script_pass_on_error);
+	if (!script.valid()) {
+		sol::error error = script;
+		Logger::Error("Failed to load level script " + m_scriptPath + ": " + error.what());
+		return false;
+	}
+
+	sol::optional<sol::table> levelTable = lua["Level"];
+	if (!levelTable) {
+		Logger::Error("Level script has no Level table: " + m_scriptPath);
+		return false;
+	}
+
+	if (sol::optional<sol::table> assets = (*levelTable)["assets"]) {
+		LoadAssets(*assets, assetManager, renderer);
+	}
+	if (sol::optional<sol::table> scripts = (*levelTable)["scripts"]) {
+		LoadScripts(*scripts, lua, registry);
+	}
+	if (sol::optional<sol::table> animationClips = (*levelTable)["animation_clips"]) {
+		LoadAnimationClips(*animationClips);
+	}
+	if (sol::optional<sol::table> eventSounds = (*levelTable)["event_sounds"]) {
+		registry->GetSystem<AudioSystem>().SetEventSounds(
+			eventSounds->get_or<std::string>("projectile_fired", ""),
+			eventSounds->get_or<std::string>("collision", "")
+		);
+	}
+	if (sol::optional<sol::table> tilemap = (*levelTable)["tilemap"]) {
+		if (!LoadTilemap(*tilemap, registry)) {
+			return false;
+		}
+	}
+	if (sol::optional<sol::table> entities = (*levelTable)["entities"]) {
+		LoadEntities(*entities, registry);
+	}
+
+	Logger::Info("Loaded level script " + m_scriptPath);
+	return true;
+}
+
+void LevelLoader::LoadAssets(const sol::table& assets, const std::unique_ptr<AssetManager>& assetManager, SDL_Renderer* renderer) {
+	for (size_t i = 1; i <= assets.size(); i++) {
+		sol::optional<sol::table> asset = assets[i];
+		if (!asset) continue;
+
+		const std::string type = asset->get_or<std::string>("type", "");
+		const std::string assetId = asset->get_or<std::string>("id", "");
+		const std::string filePath = asset->get_or<std::string>("file", "");
+
+		if (type == "texture") {
+			assetManager->AddTexture(assetId, filePath, renderer);
+		}
+		else if (type == "sound") {
+			assetManager->AddSound(assetId, filePath);
+		}
+		else if (type == "font") {
+			assetManager->AddFont(assetId, filePath, asset->get_or("font_size", 16), renderer);
+		}
+		else {
+			Logger::Warning("Unknown asset type '" + type + "' for asset " + assetId);
+		}
+	}
+}
+
+void LevelLoader::LoadScripts(const sol::table& scripts, sol::state& lua, const std::unique_ptr<Registry>& registry) {
+	auto& scriptSystem = registry->GetSystem<ScriptSystem>();
+
+	// An array rather than a name-keyed table, so script ids and the order
+	// scripts run in do not depend on Lua's hash order
+	for (size_t i = 1; i <= scripts.size(); i++) {
+		sol::optional<sol::table> script = scripts[i];
+		if (!script) continue;
+
+		const std::string name = script->get_or<std::string>("name", "");
+		sol::optional<sol::protected_function> update = (*script)["update"];
+		if (name.empty() || !update) {
+			Logger::Warning("Script entry " + std::to_string(i) + " needs a name and an update function");
+			continue;
+		}
+		scriptSystem.AddScript(lua, name, *update);
+	}
+}
+
+void LevelLoader::LoadAnimationClips(const sol::table& animationClips) {
+	for (size_t i = 1; i <= animationClips.size(); i++) {
+		sol::optional<sol::table> clip = animationClips[i];
+		if (!clip) continue;
+
+		const std::string name = clip->get_or<std::string>("name", "");
+		sol::optional<sol::table> columns = (*clip)["frames"];
+		if (name.empty() || !columns) {
+			Logger::Warning("Animation clip entry " + std::to_string(i) + " needs a name and frames");
+			continue;
+		}
+
+		// Either one duration for every frame or a durations list
+		const float frameDuration = clip->get_or("frame_duration", 0.1f);
+		sol::optional<sol::table> durations = (*clip)["durations"];
+
+		std::vector<AnimationFrame> frames;
+		for (size_t j = 1; j <= columns->size(); j++) {
+			const float duration = durations ? durations->get_or(j, frameDuration) : frameDuration;
+			frames.push_back({ columns->get_or(j, 0), duration });
+		}
+		AnimationClips::AddClip(name, frames, ReadPlayback(clip->get_or<std::string>("playback", "loop")));
+	}
+}
+
+bool LevelLoader::LoadTilemap(const sol::table& tilemap, const std::unique_ptr<Registry>& registry) {
+	m_mapFilePath = tilemap.get_or<std::string>("map_file", "");
+	m_tileSize = tilemap.get_or("tile_size", 32);
+	m_tileScale = tilemap.get_or("scale", 1.0);
+	m_mapNumCols = tilemap.get_or("num_cols", 0);
+	m_mapNumRows = tilemap.get_or("num_rows", 0);
+	const std::string textureAssetId = tilemap.get_or<std::string>("texture_asset_id", "");
+
+	std::vector<SDL_Point> srcRectPositions;
+	if (!ReadTilemapFile(m_mapFilePath, m_mapNumRows, m_mapNumCols, m_tileSize, srcRectPositions)) {
+		return false;
+	}
+
+	Prefab tilePrefab;
+	tilePrefab.AddComponent<TransformComponent>(glm::vec2(0, 0), glm::vec2(m_tileScale, m_tileScale), 0.0);
+	tilePrefab.AddComponent<SpriteComponent>(textureAssetId, m_tileSize, m_tileSize, 0, false);
+
+	std::vector<Entity> tiles = registry->Instantiate(tilePrefab, m_mapNumRows * m_mapNumCols);
+
+	for (int y = 0; y < m_mapNumRows; y++) {
+		for (int x = 0; x < m_mapNumCols; x++) {
+			const int tileIndex = y * m_mapNumCols + x;
+			Entity& tile = tiles[tileIndex];
+			tile.Group("tiles");
+			// Both positions, tiles never move so nothing else syncs the
+			// interpolation start
+			auto& transform = tile.GetComponent<TransformComponent>();
+			transform.position = glm::vec2(x * (m_tileScale * m_tileSize), y * (m_tileScale * m_tileSize));
+			transform.previousPosition = transform.position;
+
+			auto& sprite = tile.GetComponent<SpriteComponent>();
+			sprite.srcRect.x = srcRectPositions[tileIndex].x;
+			sprite.srcRect.y = srcRectPositions[tileIndex].y;
+		}
+	}
+
+	Game::mapWidth = m_mapNumCols * m_tileSize * m_tileScale;
+	Game::mapHeight = m_mapNumRows * m_tileSize * m_tileScale;
+	return true;
+}
+
+bool LevelLoader::ReloadTilemap(const std::unique_ptr<Registry>& registry) {
+	std::vector<SDL_Point> srcRectPositions;
+	if (!ReadTilemapFile(m_mapFilePath, m_mapNumRows, m_mapNumCols, m_tileSize, srcRectPositions)) {
+		return false;
+	}
+
+	// Tiles never move, their cell comes back from the position. Group order
+	// follows entity ids, which snapshots and recycling do not keep in step
+	// with the map.
+	const double cellSize = m_tileScale * m_tileSize;
+	for (const auto& tile : registry->GetEntitiesByGroup("tiles")) {
+		const auto& transform = tile.GetComponent<TransformComponent>();
+		const int x = static_cast<int>(transform.position.x / cellSize + 0.5);
+		const int y = static_cast<int>(transform.position.y / cellSize + 0.5);
+		if (x < 0 || x >= m_mapNumCols || y < 0 || y >= m_mapNumRows) continue;
+
+		auto& sprite = tile.GetComponent<SpriteComponent>();
+		sprite.srcRect.x = srcRectPositions[y * m_mapNumCols + x].x;
+		sprite.srcRect.y = srcRectPositions[y * m_mapNumCols + x].y;
+	}
+
+	Logger::Info("Reloaded tilemap " + m_mapFilePath);
+	return true;
+}
+
+bool LevelLoader::ReloadFile(const std::string& filePath, sol::state& lua, const std::unique_ptr<Registry>& registry) {
+	if (filePath == m_mapFilePath) {
+		ReloadTilemap(registry);
+		return true;
+	}
+	if (filePath != m_scriptPath) {
+		return false;
+	}
+
+	sol::protected_function_result script = lua.safe_script_file(m_scriptPath, sol::script_pass_on_error);
+	if (!script.valid()) {
+		sol::error error = script;
+		Logger::Error("Failed to reload level script " + m_scriptPath + ": " + error.what());
+		return true;
+	}
+
+	sol::optional<sol::table> scripts = lua["Level"]["scripts"];
+	if (scripts) {
+		LoadScripts(*scripts, lua, registry);
+	}
+	Logger::Info("Reloaded scripts of " + m_scriptPath);
+	return true;
+}
+
+std::vector<std::string> LevelLoader::GetSourceFilePaths() const {
+	std::vector<std::string> filePaths;
+	if (!m_scriptPath.empty()) filePaths.push_back(m_scriptPath);
+	if (!m_mapFilePath.empty()) filePaths.push_back(m_mapFilePath);
+	return filePaths;
+}
+
+void LevelLoader::LoadEntities(const sol::table& entities, const std::unique_ptr<Registry>& registry) {
+	const auto& scriptSystem = registry->GetSystem<ScriptSystem>();
+
+	for (size_t i = 1; i <= entities.size(); i++) {
+		sol::optional<sol::table> entityTable = entities[i];
+		if (!entityTable) continue;
+
+		Prefab prefab;
+		if (sol::optional<sol::table> components = (*entityTable)["components"]) {
+			ReadPrefab(*components, scriptSystem, prefab);
+		}
+
+		// An optional `positions` array places one instance per entry, all
+		// created in a single Instantiate call
+		std::vector<glm::vec2> positions;
+		if (sol::optional<sol::table> positionTable = (*entityTable)["positions"]) {
+			positions.reserve(positionTable->size());
+			for (size_t j = 1; j <= positionTable->size(); j++) {
+				sol::optional<sol::table> position = (*positionTable)[j];
+				if (!position) continue;
+				positions.emplace_back(position->get_or("x", 0.0), position->get_or("y", 0.0));
+			}
+			if (!positions.empty() && !prefab.HasComponent<TransformComponent>()) {
+				prefab.AddComponent<TransformComponent>();
+			}
+		}
+
+		const int count = positions.empty() ? 1 : static_cast<int>(positions.size());
+		std::vector<Entity> instances = registry->Instantiate(prefab, count);
+
+		const std::string tag = entityTable->get_or<std::string>("tag", "");
+		const std::string group = entityTable->get_or<std::string>("group", "");
+		if (!tag.empty() && count > 1) {
+			Logger::Warning("Tag '" + tag + "' is ignored on an entity with several positions");
+		}
+
+		for (int j = 0; j < count; j++) {
+			const Entity& entity = instances[j];
+			if (!positions.empty()) {
+				auto& transform = entity.GetComponent<TransformComponent>();
+				transform.position = positions[j];
+				transform.previousPosition = positions[j];
+			}
+			if (!tag.empty() && count == 1) {
+				entity.Tag(tag);
+			}
+			if (!group.empty()) {
+				entity.Group(group);
+			}
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#ifndef LEVELLOADER_H
+#define LEVELLOADER_H
+
+#include <SDL.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sol/sol.hpp>
+
+#include "../ECS/ECS.h"
+#include "../AssetManager/AssetManager.h"
+
+// Builds a level from the `Level` table of ./assets/scripts/Level<N>.lua.
+// Each entity table is read once into a Prefab and instantiated in bulk, so
+// Lua is only touched while parsing and never per component or per instance.
+class LevelLoader {
+	private:
+		// Sources of the loaded level, kept for hot reload
+		std::string m_scriptPath;
+		std::string m_mapFilePath;
+		int m_tileSize = 0;
+		double m_tileScale = 1.0;
+		int m_mapNumCols = 0;
+		int m_mapNumRows = 0;
+
+	public:
+		bool LoadLevel(
+			sol::state& lua,
+			const std::unique_ptr<Registry>& registry,
+			const std::unique_ptr<AssetManager>& assetManager,
+			SDL_Renderer* renderer,
+			int level
+		);
+
+		// Hot reload of a changed source file between frames. The tilemap is
+		// re-read into the existing tiles' sprites and the script only re-binds
+		// the script functions, entities and their state are left alone.
+		// Returns false when filePath is not a source of this level.
+		bool ReloadFile(const std::string& filePath, sol::state& lua, const std::unique_ptr<Registry>& registry);
+		std::vector<std::string> GetSourceFilePaths() const;
+
+	private:
+		void LoadAssets(const sol::table& assets, const std::unique_ptr<AssetManager>& assetManager, SDL_Renderer* renderer);
+		void LoadScripts(const sol::table& scripts, sol::state& lua, const std::unique_ptr<Registry>& registry);
+		void LoadAnimationClips(const sol::table& animationClips);
+		bool LoadTilemap(const sol::table& tilemap, const std::unique_ptr<Registry>& registry);
+		bool ReloadTilemap(const std::unique_ptr<Registry>& registry);
+		void LoadEntities(const sol::table& entities, const std::unique_ptr<Registry>& registry);
+};
+
+#endif
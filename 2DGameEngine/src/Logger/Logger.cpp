@@ -1,57 +1,217 @@
 #include <iostream>
 #include <string>
+#include <cstring>
+#include <algorithm>
 #include <chrono>
 #include <ctime>
+#include <fstream>
+#include <mutex>
+#include <atomic>
+#include <vector>
 
 #include "Logger.h"
 
-std::vector<LogEntry> Logger::messages;
+LogRing Logger::messages;
+bool Logger::m_isEnabled = true;
+
+namespace {
+    std::mutex messagesMutex;
+}
 
 std::string CurrentDateTimeToString() {
     std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
     std::tm localTime;
     localtime_s(&localTime, &now);
     std::string output(30, '\0');
-    std::strftime(&output[0], output.size(), "%d-%b-%Y %H:%M:%S", &localTime);
+    output.resize(std::strftime(&output[0], output.size(), "%d-%b-%Y %H:%M:%S", &localTime));
     return output;
 }
 
+void LogRing::Push(LogType type, const std::string& message) {
+    LogEntry& entry = m_entries[m_head];
+
+    if (m_size == MAX_LOG_ENTRIES) {
+        m_countPerType[entry.type]--;
+    }
+    else {
+        m_size++;
+    }
+
+    entry.type = type;
+    entry.length = static_cast<unsigned int>(std::min<size_t>(message.size(), MAX_LOG_MESSAGE_LENGTH - 1));
+    std::memcpy(entry.message, message.data(), entry.length);
+    entry.message[entry.length] = '\0';
+
+    m_countPerType[type]++;
+    m_head = (m_head + 1) % MAX_LOG_ENTRIES;
+}
+
+void LogRing::Clear() {
+    m_countPerType.fill(0);
+    m_head = 0;
+    m_size = 0;
+}
+
+void Logger::SetEnabled(bool isEnabled) {
+    m_isEnabled = isEnabled;
+}
+
 void Logger::Info(const std::string& message) {
-    LogEntry logEntry;
-    logEntry.type = LOG_INFO;
-    logEntry.message = "INFO: [" + CurrentDateTimeToString() + "]: " + message;
-    std::cout << "\x1B[34m" << logEntry.message << "\033[0m" << std::endl;
-    messages.push_back(logEntry);
+    if (!m_isEnabled) return;
+    std::string output = "INFO: [" + CurrentDateTimeToString() + "]: " + message;
+    std::lock_guard<std::mutex> lock(messagesMutex);
+    std::cout << "\x1B[34m" << output << "\033[0m" << std::endl;
+    messages.Push(LOG_INFO, output);
 }
 
 void Logger::Success(const std::string& message) {
-    LogEntry logEntry;
-    logEntry.type = LOG_SUCCESS;
-    logEntry.message = "SUCCESS: [" + CurrentDateTimeToString() + "]: " + message;
-    std::cout << "\x1B[32m" << logEntry.message << "\033[0m" << std::endl;
-    messages.push_back(logEntry);
+    if (!m_isEnabled) return;
+    std::string output = "SUCCESS: [" + CurrentDateTimeToString() + "]: " + message;
+    std::lock_guard<std::mutex> lock(messagesMutex);
+    std::cout << "\x1B[32m" << output << "\033[0m" << std::endl;
+    messages.Push(LOG_SUCCESS, output);
 }
 
 void Logger::Error(const std::string& message) {
-    LogEntry logEntry;
-    logEntry.type = LOG_ERROR;
-    logEntry.message = "ERROR: [" + CurrentDateTimeToString() + "]: " + message;
-    std::cout << "\x1B[31m" << logEntry.message << "\033[0m" << std::endl;
-    messages.push_back(logEntry);
+    if (!m_isEnabled) return;
+    std::string output = "ERROR: [" + CurrentDateTimeToString() + "]: " + message;
+    std::lock_guard<std::mutex> lock(messagesMutex);
+    std::cout << "\x1B[31m" << output << "\033[0m" << std::endl;
+    messages.Push(LOG_ERROR, output);
 }
 
 void Logger::Warning(const std::string& message) {
-    LogEntry logEntry;
-    logEntry.type = LOG_WARNING;
-    logEntry.message = "WARNING: [" + CurrentDateTimeToString() + "]: " + message;
-    std::cout << "\x1B[33m" << logEntry.message << "\033[0m" << std::endl;
-    messages.push_back(logEntry);
+    if (!m_isEnabled) return;
+    std::string output = "WARNING: [" + CurrentDateTimeToString() + "]: " + message;
+    std::lock_guard<std::mutex> lock(messagesMutex);
+    std::cout << "\x1B[33m" << output << "\033[0m" << std::endl;
+    messages.Push(LOG_WARNING, output);
 }
 
 void Logger::Log(const std::string& message) {
-    LogEntry logEntry;
-    logEntry.type = LOG_DEFAULT;
-    logEntry.message = "LOG: [" + CurrentDateTimeToString() + "]: " + message;
-    std::cout << "\x1B[37m" << logEntry.message << "\033[0m" << std::endl;
-    messages.push_back(logEntry);
+    if (!m_isEnabled) return;
+    std::string output = "LOG: [" + CurrentDateTimeToString() + "]: " + message;
+    std::lock_guard<std::mutex> lock(messagesMutex);
+    std::cout << "\x1B[37m" << output << "\033[0m" << std::endl;
+    messages.Push(LOG_DEFAULT, output);
+}
+
+// Binary trace
+namespace {
+    const size_t TRACE_BUFFER_RECORDS = 4096;
+
+    std::ofstream traceFile;
+    std::mutex traceMutex;
+    std::vector<TraceRecord> traceBuffer;
+    std::chrono::steady_clock::time_point traceStartTime;
+    std::atomic<bool> isTracing(false);
+    std::atomic<uint32_t> nextTraceThreadId(0);
+    std::vector<std::string> traceCategories;
+
+    uint32_t CurrentTraceThreadId() {
+        thread_local uint32_t threadId = nextTraceThreadId++;
+        return threadId;
+    }
+
+    void FlushTraceBuffer() {
+        traceFile.write(reinterpret_cast<const char*>(traceBuffer.data()), traceBuffer.size() * sizeof(TraceRecord));
+        traceBuffer.clear();
+    }
+
+    // Category names are written inline so the converter can resolve ids
+    void WriteTraceCategory(uint16_t categoryId) {
+        const std::string name = traceCategories[categoryId].substr(0, TRACE_MAX_CATEGORY_NAME_SIZE);
+
+        TraceRecord record = {};
+        record.threadId = CurrentTraceThreadId();
+        record.categoryId = categoryId;
+        record.kind = TRACE_CATEGORY;
+        record.payload = name.size();
+
+        const char padding[8] = {};
+        traceFile.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        traceFile.write(name.data(), name.size());
+        traceFile.write(padding, (8 - name.size() % 8) % 8);
+    }
+}
+
+bool Logger::OpenTrace(const std::string& filePath) {
+    std::lock_guard<std::mutex> lock(traceMutex);
+
+    if (traceFile.is_open()) {
+        Warning("A trace is already being recorded, ignoring: " + filePath);
+        return false;
+    }
+
+    traceFile.open(filePath, std::ios::binary | std::ios::trunc);
+    if (!traceFile.is_open()) {
+        Error("Failed to open trace file: " + filePath);
+        return false;
+    }
+
+    TraceFileHeader header = { TRACE_MAGIC, TRACE_VERSION };
+    traceFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t categoryId = 0; categoryId < traceCategories.size(); categoryId++) {
+        WriteTraceCategory(static_cast<uint16_t>(categoryId));
+    }
+
+    traceBuffer.reserve(TRACE_BUFFER_RECORDS);
+    traceStartTime = std::chrono::steady_clock::now();
+    isTracing = true;
+
+    Info("Recording binary trace to " + filePath);
+    return true;
+}
+
+void Logger::CloseTrace() {
+    std::lock_guard<std::mutex> lock(traceMutex);
+
+    if (!traceFile.is_open()) return;
+
+    isTracing = false;
+    FlushTraceBuffer();
+    traceFile.close();
+}
+
+bool Logger::IsTracing() {
+    return isTracing;
+}
+
+uint16_t Logger::RegisterTraceCategory(const std::string& name) {
+    std::lock_guard<std::mutex> lock(traceMutex);
+
+    auto category = std::find(traceCategories.begin(), traceCategories.end(), name);
+    if (category != traceCategories.end()) {
+        return static_cast<uint16_t>(category - traceCategories.begin());
+    }
+
+    uint16_t categoryId = static_cast<uint16_t>(traceCategories.size());
+    traceCategories.push_back(name);
+
+    if (traceFile.is_open()) {
+        FlushTraceBuffer();
+        WriteTraceCategory(categoryId);
+    }
+
+    return categoryId;
+}
+
+void Logger::Trace(uint16_t categoryId, TraceEventKind kind, uint64_t payload) {
+    if (!isTracing) return;
+
+    TraceRecord record;
+    record.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceStartTime).count();
+    record.threadId = CurrentTraceThreadId();
+    record.categoryId = categoryId;
+    record.kind = kind;
+    record.reserved = 0;
+    record.payload = payload;
+
+    std::lock_guard<std::mutex> lock(traceMutex);
+    if (!traceFile.is_open()) return;
+
+    traceBuffer.push_back(record);
+    if (traceBuffer.size() >= TRACE_BUFFER_RECORDS) {
+        FlushTraceBuffer();
+    }
 }
\ No newline at end of file
@@ -1,30 +1,97 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <array>
 #include <string>
-#include <vector>
+#include <cstdint>
+
+#include "TraceFormat.h"
+
+const unsigned int MAX_LOG_ENTRIES = 1024;
+const unsigned int MAX_LOG_MESSAGE_LENGTH = 256;
 
 enum LogType {
 	LOG_INFO,
 	LOG_WARNING,
 	LOG_SUCCESS,
 	LOG_ERROR,
-	LOG_DEFAULT
+	LOG_DEFAULT,
+	LOG_TYPE_COUNT
 };
 
 struct LogEntry {
 	LogType type;
-	std::string message;
+	unsigned int length;
+	char message[MAX_LOG_MESSAGE_LENGTH];
+
+	const char* Begin() const { return message; }
+	const char* End() const { return message + length; }
 };
 
+// Fixed-capacity ring of log records. The message storage is allocated once,
+// when the ring is full the oldest entry is overwritten.
+class LogRing {
+	private:
+		std::array<LogEntry, MAX_LOG_ENTRIES> m_entries;
+		std::array<unsigned int, LOG_TYPE_COUNT> m_countPerType = {};
+		unsigned int m_head = 0;
+		unsigned int m_size = 0;
+
+	public:
+		void Push(LogType type, const std::string& message);
+		void Clear();
+
+		unsigned int GetSize() const { return m_size; }
+		unsigned int GetCapacity() const { return MAX_LOG_ENTRIES; }
+		unsigned int GetCountByType(LogType type) const { return m_countPerType[type]; }
+
+		// index 0 is the oldest entry still in the ring
+		const LogEntry& operator [](unsigned int index) const {
+			return m_entries[(m_head + MAX_LOG_ENTRIES - m_size + index) % MAX_LOG_ENTRIES];
+		}
+
+		template <typename TCallback> void ForEach(TCallback callback) const;
+		template <typename TCallback> void ForEachOfType(LogType type, TCallback callback) const;
+};
+
+template <typename TCallback>
+void LogRing::ForEach(TCallback callback) const {
+	for (unsigned int i = 0; i < m_size; i++) {
+		callback((*this)[i]);
+	}
+}
+
+template <typename TCallback>
+void LogRing::ForEachOfType(LogType type, TCallback callback) const {
+	if (m_countPerType[type] == 0) return;
+
+	for (unsigned int i = 0; i < m_size; i++) {
+		const LogEntry& entry = (*this)[i];
+		if (entry.type == type) {
+			callback(entry);
+		}
+	}
+}
+
 class Logger {
+	private:
+		static bool m_isEnabled;
+
 	public:
-		static std::vector<LogEntry> messages;
+		static LogRing messages;
+		static void SetEnabled(bool isEnabled);
 		static void Log(const std::string& message);
 		static void Info(const std::string& message);
 		static void Success(const std::string& message);
 		static void Error(const std::string& message);
 		static void Warning(const std::string& message);
+
+		// Binary trace
+		static bool OpenTrace(const std::string& filePath);
+		static void CloseTrace();
+		static bool IsTracing();
+		static uint16_t RegisterTraceCategory(const std::string& name);
+		static void Trace(uint16_t categoryId, TraceEventKind kind, uint64_t payload = 0);
 };
 
 #endif
\ No newline at end of file
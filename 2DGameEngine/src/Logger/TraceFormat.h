@@ -0,0 +1,42 @@
+#ifndef TRACEFORMAT_H
+#define TRACEFORMAT_H
+
+#include <cstdint>
+
+// On-disk layout of the binary trace written by Logger::OpenTrace.
+// The file is a TraceFileHeader followed by a stream of TraceRecords.
+// A TRACE_CATEGORY record is followed by `payload` bytes of category name,
+// padded to a multiple of 8 bytes. Timestamps are nanoseconds since the
+// trace was opened.
+
+const uint32_t TRACE_MAGIC = 0x52544432; // "2DTR"
+const uint32_t TRACE_VERSION = 1;
+// Longer category names are cut when written, readers reject larger sizes
+const uint64_t TRACE_MAX_CATEGORY_NAME_SIZE = 256;
+
+enum TraceEventKind : uint8_t {
+	TRACE_CATEGORY,
+	TRACE_BEGIN,
+	TRACE_END,
+	TRACE_INSTANT,
+	TRACE_COUNTER
+};
+
+struct TraceFileHeader {
+	uint32_t magic;
+	uint32_t version;
+};
+
+struct TraceRecord {
+	uint64_t timestamp;
+	uint32_t threadId;
+	uint16_t categoryId;
+	uint8_t kind;
+	uint8_t reserved;
+	uint64_t payload;
+};
+
+static_assert(sizeof(TraceFileHeader) == 8, "TraceFileHeader must be 8 bytes");
+static_assert(sizeof(TraceRecord) == 24, "TraceRecord must be 24 bytes");
+
+#endif
\ No newline at end of file
@@ -1,10 +1,55 @@
+#include <string>
+#include <cstdlib>
+
 #include "./Game/Game.h"
+#include "./Logger/Logger.h"
 
 int main(int argc, char* argv[]) {
+    bool isHeadless = false;
+    int headlessFrames = 0;
+    bool isDeterministic = false;
+    std::string recordFilePath;
+    std::string replayFilePath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--trace" && i + 1 < argc) {
+            Logger::OpenTrace(argv[++i]);
+        }
+        else if (argument == "--deterministic") {
+            isDeterministic = true;
+        }
+        else if (argument == "--record" && i + 1 < argc) {
+            recordFilePath = argv[++i];
+        }
+        else if (argument == "--replay" && i + 1 < argc) {
+            replayFilePath = argv[++i];
+        }
+        else if (argument == "--headless" && i + 1 < argc) {
+            isHeadless = true;
+            headlessFrames = std::atoi(argv[++i]);
+        }
+    }
+
     Game game;
+    game.SetDeterministic(isDeterministic);
+    if (!recordFilePath.empty()) {
+        game.StartInputRecording(recordFilePath);
+    }
+    if (!replayFilePath.empty() && !game.StartInputReplay(replayFilePath)) {
+        return 1;
+    }
 
-    game.Initialize();
-    game.Run();
+    if (isHeadless) {
+        game.InitializeHeadless();
+        game.RunHeadless(headlessFrames);
+    }
+    else {
+        game.Initialize();
+        game.Run();
+    }
     game.Destroy();
+
+    Logger::CloseTrace();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "FrameAllocator.h"
+#include "../Logger/Logger.h"
+
+std::unique_ptr<unsigned char[]> FrameAllocator::m_buffer;
+size_t FrameAllocator::m_capacity = 0;
+std::atomic<size_t> FrameAllocator::m_offset(0);
+std::atomic<size_t> FrameAllocator::m_bytesAllocated(0);
+std::vector<std::unique_ptr<unsigned char[]>> FrameAllocator::m_overflowBlocks;
+std::mutex FrameAllocator::m_overflowMutex;
+size_t FrameAllocator::m_lastFrameBytes = 0;
+size_t FrameAllocator::m_peakFrameBytes = 0;
+
+namespace {
+	uint16_t FrameAllocatorTraceCategory() {
+		static const uint16_t frameAllocatorTraceCategory = Logger::RegisterTraceCategory("FrameAllocatorBytes");
+		return frameAllocatorTraceCategory;
+	}
+
+	void* AlignPointer(unsigned char* pointer, size_t alignment) {
+		const uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+		return reinterpret_cast<void*>((address + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1));
+	}
+}
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment) {
+	if (size == 0) size = 1;
+
+	// Reserve enough to align inside the reserved range whatever the offset is
+	const size_t reservedSize = size + alignment - 1;
+	m_bytesAllocated.fetch_add(reservedSize, std::memory_order_relaxed);
+
+	const size_t offset = m_offset.fetch_add(reservedSize, std::memory_order_relaxed);
+	if (offset + reservedSize <= m_capacity) {
+		return AlignPointer(m_buffer.get() + offset, alignment);
+	}
+
+	std::lock_guard<std::mutex> lock(m_overflowMutex);
+	m_overflowBlocks.emplace_back(new unsigned char[reservedSize]);
+	return AlignPointer(m_overflowBlocks.back().get(), alignment);
+}
+
+void FrameAllocator::Reset() {
+	m_lastFrameBytes = m_bytesAllocated.load(std::memory_order_relaxed);
+	m_peakFrameBytes = std::max(m_peakFrameBytes, m_lastFrameBytes);
+
+	if (m_lastFrameBytes > m_capacity || !m_buffer) {
+		size_t newCapacity = std::max(m_capacity, FRAME_ALLOCATOR_INITIAL_CAPACITY);
+		while (newCapacity < m_lastFrameBytes) {
+			newCapacity *= 2;
+		}
+
+		if (m_buffer) {
+			Logger::Warning("Frame allocator grown to " + std::to_string(newCapacity) + " bytes");
+		}
+		m_buffer.reset(new unsigned char[newCapacity]);
+		m_capacity = newCapacity;
+	}
+
+	m_overflowBlocks.clear();
+	m_offset.store(0, std::memory_order_relaxed);
+	m_bytesAllocated.store(0, std::memory_order_relaxed);
+
+	Logger::Trace(FrameAllocatorTraceCategory(), TRACE_COUNTER, m_lastFrameBytes);
+}
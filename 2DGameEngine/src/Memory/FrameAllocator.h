@@ -0,0 +1,64 @@
+#ifndef FRAMEALLOCATOR_H
+#define FRAMEALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+const size_t FRAME_ALLOCATOR_INITIAL_CAPACITY = 1024 * 1024;
+
+// Linear (bump) allocator for temporaries that live for one frame. Memory is
+// never freed individually, Reset (at the top of Game::Update) releases
+// everything at once. Allocate is thread safe: the bump pointer is atomic and
+// a request that does not fit goes to an overflow block, after which Reset
+// grows the arena so the next frames fit again.
+class FrameAllocator {
+	private:
+		static std::unique_ptr<unsigned char[]> m_buffer;
+		static size_t m_capacity;
+		static std::atomic<size_t> m_offset;
+		static std::atomic<size_t> m_bytesAllocated;
+		static std::vector<std::unique_ptr<unsigned char[]>> m_overflowBlocks;
+		static std::mutex m_overflowMutex;
+		static size_t m_lastFrameBytes;
+		static size_t m_peakFrameBytes;
+
+	public:
+		static void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+		// Nothing allocated since the previous Reset may be used afterwards
+		static void Reset();
+
+		static size_t GetCapacity() { return m_capacity; }
+		static size_t GetBytesAllocated() { return m_bytesAllocated.load(std::memory_order_relaxed); }
+		static size_t GetLastFrameBytes() { return m_lastFrameBytes; }
+		static size_t GetPeakFrameBytes() { return m_peakFrameBytes; }
+};
+
+// STL allocator on top of the FrameAllocator, deallocate is a no-op
+template <typename T>
+class FrameStlAllocator {
+	public:
+		typedef T value_type;
+
+		FrameStlAllocator() = default;
+		template <typename U> FrameStlAllocator(const FrameStlAllocator<U>&) {}
+
+		T* allocate(size_t count) {
+			return static_cast<T*>(FrameAllocator::Allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T*, size_t) {}
+};
+
+template <typename T, typename U>
+bool operator ==(const FrameStlAllocator<T>&, const FrameStlAllocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator !=(const FrameStlAllocator<T>&, const FrameStlAllocator<U>&) { return false; }
+
+template <typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+#endif
@@ -0,0 +1,77 @@
+#include "ParticleBuffer.h"
+
+#ifdef PARTICLES_SSE2
+#include <emmintrin.h>
+#endif
+
+ParticleBuffer::ParticleBuffer(size_t capacity):
+	m_positionX(capacity),
+	m_positionY(capacity),
+	m_velocityX(capacity),
+	m_velocityY(capacity),
+	m_age(capacity),
+	m_lifetime(capacity),
+	m_size(capacity),
+	m_startColor(capacity),
+	m_endColor(capacity) {
+}
+
+bool ParticleBuffer::Add(glm::vec2 position, glm::vec2 velocity, float lifetime, float size, SDL_Color startColor, SDL_Color endColor) {
+	if (m_count >= GetCapacity()) return false;
+
+	const size_t i = m_count++;
+	m_positionX[i] = position.x;
+	m_positionY[i] = position.y;
+	m_velocityX[i] = velocity.x;
+	m_velocityY[i] = velocity.y;
+	m_age[i] = 0.0f;
+	m_lifetime[i] = lifetime;
+	m_size[i] = size;
+	m_startColor[i] = startColor;
+	m_endColor[i] = endColor;
+	return true;
+}
+
+void ParticleBuffer::Integrate(float deltaTime, size_t begin, size_t end) {
+	float* positionX = m_positionX.data();
+	float* positionY = m_positionY.data();
+	const float* velocityX = m_velocityX.data();
+	const float* velocityY = m_velocityY.data();
+	float* age = m_age.data();
+
+	size_t i = begin;
+#ifdef PARTICLES_SSE2
+	const __m128 delta = _mm_set1_ps(deltaTime);
+	for (; i + 4 <= end; i += 4) {
+		_mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(_mm_loadu_ps(velocityX + i), delta)));
+		_mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(_mm_loadu_ps(velocityY + i), delta)));
+		_mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), delta));
+	}
+#endif
+	for (; i < end; i++) {
+		positionX[i] += velocityX[i] * deltaTime;
+		positionY[i] += velocityY[i] * deltaTime;
+		age[i] += deltaTime;
+	}
+}
+
+void ParticleBuffer::RemoveDead() {
+	size_t i = 0;
+	while (i < m_count) {
+		if (m_age[i] < m_lifetime[i]) {
+			i++;
+			continue;
+		}
+
+		const size_t last = --m_count;
+		m_positionX[i] = m_positionX[last];
+		m_positionY[i] = m_positionY[last];
+		m_velocityX[i] = m_velocityX[last];
+		m_velocityY[i] = m_velocityY[last];
+		m_age[i] = m_age[last];
+		m_lifetime[i] = m_lifetime[last];
+		m_size[i] = m_size[last];
+		m_startColor[i] = m_startColor[last];
+		m_endColor[i] = m_endColor[last];
+	}
+}
@@ -0,0 +1,53 @@
+#ifndef PARTICLEBUFFER_H
+#define PARTICLEBUFFER_H
+
+#include <SDL.h>
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Particles alive at once across every emitter, spawns past it are dropped
+const size_t MAX_PARTICLES = 100000;
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARTICLES_SSE2
+#endif
+
+// Particle state in structure-of-arrays form, outside the Registry. Each
+// attribute is its own array so the integration loads four particles per
+// SSE2 register. Removal swaps the last particle in, order is not kept.
+class ParticleBuffer {
+	private:
+		std::vector<float> m_positionX;
+		std::vector<float> m_positionY;
+		std::vector<float> m_velocityX;
+		std::vector<float> m_velocityY;
+		std::vector<float> m_age;
+		std::vector<float> m_lifetime;
+		std::vector<float> m_size;
+		std::vector<SDL_Color> m_startColor;
+		std::vector<SDL_Color> m_endColor;
+		size_t m_count = 0;
+
+	public:
+		ParticleBuffer(size_t capacity = MAX_PARTICLES);
+
+		// False when the buffer is full
+		bool Add(glm::vec2 position, glm::vec2 velocity, float lifetime, float size, SDL_Color startColor, SDL_Color endColor);
+		// Moves and ages the particles in [begin, end), ranges may run in parallel
+		void Integrate(float deltaTime, size_t begin, size_t end);
+		void RemoveDead();
+		void Clear() { m_count = 0; }
+
+		size_t GetCount() const { return m_count; }
+		size_t GetCapacity() const { return m_positionX.size(); }
+		const float* GetPositionX() const { return m_positionX.data(); }
+		const float* GetPositionY() const { return m_positionY.data(); }
+		const float* GetAge() const { return m_age.data(); }
+		const float* GetLifetime() const { return m_lifetime.data(); }
+		const float* GetSize() const { return m_size.data(); }
+		const SDL_Color* GetStartColor() const { return m_startColor.data(); }
+		const SDL_Color* GetEndColor() const { return m_endColor.data(); }
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include <algorithm>
+
+#include "Profiler.h"
+#include "../Logger/Logger.h"
+
+std::vector<ProfilerZone> Profiler::m_zones;
+std::vector<Profiler::OpenZone> Profiler::m_openZones;
+std::array<float, PROFILER_HISTORY_FRAMES> Profiler::m_frameTimes = {};
+Profiler::Clock::time_point Profiler::m_frameStartTime;
+unsigned int Profiler::m_frameIndex = 0;
+unsigned int Profiler::m_numOfFrames = 0;
+
+namespace {
+	uint16_t FrameTraceCategory() {
+		static const uint16_t frameTraceCategory = Logger::RegisterTraceCategory("Frame");
+		return frameTraceCategory;
+	}
+}
+
+float ProfilerZone::GetLast() const {
+	return samples[(Profiler::GetHistoryOffset() + PROFILER_HISTORY_FRAMES - 1) % PROFILER_HISTORY_FRAMES];
+}
+
+float ProfilerZone::GetMin() const {
+	const unsigned int numOfSamples = std::min(Profiler::GetNumOfFrames(), PROFILER_HISTORY_FRAMES);
+	if (numOfSamples == 0) return 0.0f;
+	if (numOfSamples < PROFILER_HISTORY_FRAMES) {
+		return *std::min_element(samples.begin(), samples.begin() + numOfSamples);
+	}
+	return *std::min_element(samples.begin(), samples.end());
+}
+
+float ProfilerZone::GetMax() const {
+	return *std::max_element(samples.begin(), samples.end());
+}
+
+float ProfilerZone::GetAverage() const {
+	const unsigned int numOfSamples = std::min(Profiler::GetNumOfFrames(), PROFILER_HISTORY_FRAMES);
+	if (numOfSamples == 0) return 0.0f;
+
+	float total = 0.0f;
+	for (float sample : samples) {
+		total += sample;
+	}
+	return total / numOfSamples;
+}
+
+int Profiler::RegisterZone(const std::string& name) {
+	ProfilerZone zone;
+	zone.name = name;
+	zone.parentId = -1;
+	zone.depth = 0;
+	zone.traceCategoryId = Logger::RegisterTraceCategory(name);
+	zone.currentFrameMilliseconds = 0.0;
+	zone.samples.fill(0.0f);
+
+	m_zones.push_back(zone);
+	return static_cast<int>(m_zones.size() - 1);
+}
+
+void Profiler::BeginZone(int zoneId) {
+	auto& zone = m_zones[zoneId];
+
+	// The hierarchy is taken from where the zone is first entered
+	if (zone.parentId == -1 && !m_openZones.empty()) {
+		zone.parentId = m_openZones.back().zoneId;
+		zone.depth = static_cast<int>(m_openZones.size());
+	}
+
+	Logger::Trace(zone.traceCategoryId, TRACE_BEGIN);
+	m_openZones.push_back({ zoneId, Clock::now() });
+}
+
+void Profiler::EndZone(int zoneId) {
+	const auto endTime = Clock::now();
+	const OpenZone openZone = m_openZones.back();
+	m_openZones.pop_back();
+
+	auto& zone = m_zones[zoneId];
+	zone.currentFrameMilliseconds += std::chrono::duration<double, std::milli>(endTime - openZone.startTime).count();
+	Logger::Trace(zone.traceCategoryId, TRACE_END);
+}
+
+void Profiler::RecordZone(int zoneId, double milliseconds) {
+	auto& zone = m_zones[zoneId];
+
+	if (zone.parentId == -1 && !m_openZones.empty()) {
+		zone.parentId = m_openZones.back().zoneId;
+		zone.depth = static_cast<int>(m_openZones.size());
+	}
+
+	zone.currentFrameMilliseconds += milliseconds;
+}
+
+void Profiler::BeginFrame() {
+	Logger::Trace(FrameTraceCategory(), TRACE_BEGIN, m_numOfFrames);
+	m_frameStartTime = Clock::now();
+}
+
+void Profiler::EndFrame() {
+	m_frameTimes[m_frameIndex] = static_cast<float>(std::chrono::duration<double, std::milli>(Clock::now() - m_frameStartTime).count());
+
+	for (auto& zone : m_zones) {
+		zone.samples[m_frameIndex] = static_cast<float>(zone.currentFrameMilliseconds);
+		zone.currentFrameMilliseconds = 0.0;
+	}
+
+	Logger::Trace(FrameTraceCategory(), TRACE_END, m_numOfFrames);
+
+	m_frameIndex = (m_frameIndex + 1) % PROFILER_HISTORY_FRAMES;
+	m_numOfFrames++;
+}
\ No newline at end of file
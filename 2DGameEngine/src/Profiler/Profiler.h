@@ -0,0 +1,83 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+const unsigned int PROFILER_HISTORY_FRAMES = 240;
+
+struct ProfilerZone {
+	std::string name;
+	int parentId;
+	int depth;
+	uint16_t traceCategoryId;
+	double currentFrameMilliseconds;
+	std::array<float, PROFILER_HISTORY_FRAMES> samples;
+
+	float GetLast() const;
+	float GetMin() const;
+	float GetMax() const;
+	float GetAverage() const;
+};
+
+// Hierarchical frame profiler. Zones are registered once per call site and
+// accumulate their time for the current frame, EndFrame pushes the totals
+// into a ring of the last PROFILER_HISTORY_FRAMES frames.
+// Zones must be opened and closed on the main thread.
+class Profiler {
+	private:
+		typedef std::chrono::high_resolution_clock Clock;
+
+		struct OpenZone {
+			int zoneId;
+			Clock::time_point startTime;
+		};
+
+		static std::vector<ProfilerZone> m_zones;
+		static std::vector<OpenZone> m_openZones;
+		static std::array<float, PROFILER_HISTORY_FRAMES> m_frameTimes;
+		static Clock::time_point m_frameStartTime;
+		static unsigned int m_frameIndex;
+		static unsigned int m_numOfFrames;
+
+	public:
+		static int RegisterZone(const std::string& name);
+		static void BeginZone(int zoneId);
+		static void EndZone(int zoneId);
+		// Adds time measured elsewhere (e.g. on a worker thread) to a zone
+		static void RecordZone(int zoneId, double milliseconds);
+
+		static void BeginFrame();
+		static void EndFrame();
+
+		static const std::vector<ProfilerZone>& GetZones() { return m_zones; }
+		static const std::array<float, PROFILER_HISTORY_FRAMES>& GetFrameTimes() { return m_frameTimes; }
+		// index of the oldest sample in the history rings
+		static unsigned int GetHistoryOffset() { return m_frameIndex; }
+		static unsigned int GetNumOfFrames() { return m_numOfFrames; }
+};
+
+class ProfilerScope {
+	private:
+		int m_zoneId;
+
+	public:
+		ProfilerScope(int zoneId): m_zoneId(zoneId) { Profiler::BeginZone(zoneId); }
+		~ProfilerScope() { Profiler::EndZone(m_zoneId); }
+
+		ProfilerScope(const ProfilerScope&) = delete;
+		ProfilerScope& operator =(const ProfilerScope&) = delete;
+};
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+// Times the enclosing scope under `name`, the zone is registered on first use
+#define PROFILE_SCOPE(name) \
+	static const int PROFILER_CONCAT(profilerZone, __LINE__) = Profiler::RegisterZone(name); \
+	ProfilerScope PROFILER_CONCAT(profilerScope, __LINE__)(PROFILER_CONCAT(profilerZone, __LINE__))
+
+#endif
\ No newline at end of file
@@ -2,26 +2,96 @@
 #define ANIMATIONSYSTEM_H
 
 #include <SDL.h>
+#include <algorithm>
+#include <mutex>
+#include <vector>
 
 #include "../ECS/ECS.h"
+#include "../EventBus/EventBus.h"
+#include "../Animation/AnimationClips.h"
 #include "../Components/AnimationComponent.h"
 #include "../Components/SpriteComponent.h"
+#include "../Events/AnimationFinishedEvent.h"
 
 class AnimationSystem : public System {
+	private:
+		std::vector<Entity> m_finishedEntities;
+		std::mutex m_finishedEntitiesMutex;
+
+		// Moves to the next frame of the clip, returns true when a clip played
+		// once has just ended
+		static bool AdvanceFrame(AnimationComponent& animation, const AnimationClip& clip) {
+			switch (clip.playback) {
+				case ANIMATION_LOOP:
+					animation.currentFrame = animation.currentFrame + 1 < clip.numFrames ? animation.currentFrame + 1 : 0;
+					return false;
+				case ANIMATION_ONCE:
+					if (animation.currentFrame + 1 < clip.numFrames) {
+						animation.currentFrame++;
+						return false;
+					}
+					return true;
+				case ANIMATION_PING_PONG:
+					if (clip.numFrames > 1) {
+						if (animation.currentFrame + animation.direction < 0 || animation.currentFrame + animation.direction >= clip.numFrames) {
+							animation.direction = -animation.direction;
+						}
+						animation.currentFrame += animation.direction;
+					}
+					return false;
+			}
+			return false;
+		}
+
 	public:
 		AnimationSystem() {
 			RequireComponent<AnimationComponent>();
 			RequireComponent<SpriteComponent>();
+			// Emits AnimationFinishedEvent
+			RequireExclusiveAccess();
 		}
 
-		void Update() {
-			for (auto& entity : GetSystemEntities()) {
+		void Update(double deltaTime, std::unique_ptr<EventBus>& eventBus) {
+			const AnimationFrame* frames = AnimationClips::GetFrames().data();
+			const int numOfClips = AnimationClips::GetNumOfClips();
+			const float frameDeltaTime = static_cast<float>(deltaTime);
+
+			ParallelEach([this, frames, numOfClips, frameDeltaTime](Entity entity) {
 				auto& animation = entity.GetComponent<AnimationComponent>();
+				if (animation.isFinished || animation.clipId < 0 || animation.clipId >= numOfClips) return;
+
+				const AnimationClip& clip = AnimationClips::GetClip(animation.clipId);
+				// The clip was replaced by a shorter one since (hot reload, next level)
+				if (animation.currentFrame < 0 || animation.currentFrame >= clip.numFrames) {
+					animation.currentFrame = 0;
+					animation.direction = 1;
+					animation.frameTime = 0.0f;
+				}
+				animation.frameTime += frameDeltaTime * animation.timeScale;
+
+				bool isFinished = false;
+				while (!isFinished && animation.frameTime >= frames[clip.firstFrame + animation.currentFrame].duration) {
+					animation.frameTime -= frames[clip.firstFrame + animation.currentFrame].duration;
+					isFinished = AdvanceFrame(animation, clip);
+				}
+
 				auto& sprite = entity.GetComponent<SpriteComponent>();
+				sprite.srcRect.x = frames[clip.firstFrame + animation.currentFrame].column * sprite.width;
+
+				if (isFinished) {
+					animation.isFinished = true;
+					animation.frameTime = 0.0f;
+					std::lock_guard<std::mutex> lock(m_finishedEntitiesMutex);
+					m_finishedEntities.push_back(entity);
+				}
+			}, 1024);
 
-				animation.currentFrame = ((SDL_GetTicks() - animation.startTime) * animation.frameSpeedRate / 1000) % animation.numFrames;
-				sprite.srcRect.x = animation.currentFrame * sprite.width;
+			// Chunks finish in any order, sort so events go out deterministically
+			std::sort(m_finishedEntities.begin(), m_finishedEntities.end());
+			for (const auto& entity : m_finishedEntities) {
+				eventBus->EmitEvent<AnimationFinishedEvent>(entity, entity.GetComponent<AnimationComponent>().clipId);
 			}
+			m_finishedEntities.clear();
 		}
 };
 
@@ -0,0 +1,123 @@
+#ifndef AUDIOSYSTEM_H
+#define AUDIOSYSTEM_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../ECS/ECS.h"
+#include "../EventBus/EventBus.h"
+#include "../Events/CollisionEvent.h"
+#include "../Events/ProjectileFiredEvent.h"
+#include "../AssetManager/AssetManager.h"
+#include "../Components/TransformComponent.h"
+
+// Channels SDL_mixer mixes on its audio thread, and how many of them one
+// sound may hold at once
+const int AUDIO_NUM_CHANNELS = 16;
+const int AUDIO_MAX_VOICES_PER_SOUND = 4;
+// Sounds further than this from the centre of the camera are not played
+const float AUDIO_MAX_DISTANCE = 1200.0f;
+
+// Plays the sounds bound to gameplay events. Event handlers only queue a
+// request with the world position, Update plays them once per frame: a sound
+// starts at most once per frame and on at most AUDIO_MAX_VOICES_PER_SOUND
+// channels, attenuated and panned by its offset from the camera. Mixing
+// happens on SDL's audio thread from chunks decoded at load.
+class AudioSystem: public System {
+	private:
+		struct SoundRequest {
+			const std::string* assetId;
+			glm::vec2 position;
+		};
+
+		std::string m_projectileFiredSoundId;
+		std::string m_collisionSoundId;
+		std::vector<SoundRequest> m_requests;
+		// Sound last started on each channel, for voice limiting
+		std::array<const Mix_Chunk*, AUDIO_NUM_CHANNELS> m_soundPerChannel = {};
+
+		int CountVoices(const Mix_Chunk* sound) const {
+			int numOfVoices = 0;
+			for (int channel = 0; channel < AUDIO_NUM_CHANNELS; channel++) {
+				if (m_soundPerChannel[channel] == sound && Mix_Playing(channel)) {
+					numOfVoices++;
+				}
+			}
+			return numOfVoices;
+		}
+
+	public:
+		AudioSystem() = default;
+
+		// Empty ids leave the event silent
+		void SetEventSounds(const std::string& projectileFiredSoundId, const std::string& collisionSoundId) {
+			m_projectileFiredSoundId = projectileFiredSoundId;
+			m_collisionSoundId = collisionSoundId;
+		}
+
+		// Without an audio device (headless runs and replays) nothing is queued,
+		// those loops never call Update to drain the requests
+		void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) {
+			if (!Mix_QuerySpec(nullptr, nullptr, nullptr)) return;
+
+			eventBus->SubscribeToEvent<ProjectileFiredEvent>(this, &AudioSystem::OnProjectileFired);
+			eventBus->SubscribeToEvent<CollisionEvent>(this, &AudioSystem::OnCollision);
+		}
+
+		// Both events are emitted by exclusive systems, one at a time
+		void OnProjectileFired(ProjectileFiredEvent& event) {
+			if (m_projectileFiredSoundId.empty()) return;
+			m_requests.push_back({ &m_projectileFiredSoundId, event.position });
+		}
+
+		void OnCollision(CollisionEvent& event) {
+			if (m_collisionSoundId.empty() || !event.entityA.HasComponent<TransformComponent>()) return;
+			m_requests.push_back({ &m_collisionSoundId, event.entityA.GetComponent<TransformComponent>().position });
+		}
+
+		void Update(const std::unique_ptr<AssetManager>& assetManager, const SDL_Rect& camera) {
+			if (!Mix_QuerySpec(nullptr, nullptr, nullptr)) {
+				m_requests.clear();
+				return;
+			}
+
+			const glm::vec2 listener(camera.x + camera.w * 0.5f, camera.y + camera.h * 0.5f);
+			std::array<const Mix_Chunk*, AUDIO_NUM_CHANNELS> startedSounds = {};
+			int numOfStartedSounds = 0;
+
+			for (const auto& request : m_requests) {
+				Mix_Chunk* sound = assetManager->GetSound(*request.assetId);
+				if (!sound) continue;
+
+				const glm::vec2 offset = request.position - listener;
+				const float distance = glm::length(offset);
+				if (distance >= AUDIO_MAX_DISTANCE) continue;
+
+				const auto startedEnd = startedSounds.begin() + numOfStartedSounds;
+				if (std::find(startedSounds.begin(), startedEnd, sound) != startedEnd) continue;
+				if (CountVoices(sound) >= AUDIO_MAX_VOICES_PER_SOUND) continue;
+
+				const int channel = Mix_PlayChannel(-1, sound, 0);
+				if (channel < 0 || channel >= AUDIO_NUM_CHANNELS) continue;
+
+				m_soundPerChannel[channel] = sound;
+				if (numOfStartedSounds < AUDIO_NUM_CHANNELS) {
+					startedSounds[numOfStartedSounds++] = sound;
+				}
+
+				const float pan = std::clamp(offset.x / AUDIO_MAX_DISTANCE, -1.0f, 1.0f);
+				const Uint8 right = static_cast<Uint8>(127.0f + pan * 127.0f);
+				Mix_SetPanning(channel, static_cast<Uint8>(254 - right), right);
+				Mix_SetDistance(channel, static_cast<Uint8>(distance / AUDIO_MAX_DISTANCE * 255.0f));
+			}
+
+			m_requests.clear();
+		}
+};
+
+#endif
@@ -14,16 +14,19 @@ public:
         RequireComponent<TransformComponent>();
     }
 
-    void Update(SDL_Rect& camera) {
+    void Update(SDL_Rect& camera, double alpha) {
         for (auto& entity : GetSystemEntities()) {
-            auto& transform = entity.GetComponent<TransformComponent>();
+            if (!entity.IsActive()) continue;
 
-            if (transform.position.x + (camera.w / 2) < Game::mapWidth) {
-                camera.x = transform.position.x - (Game::windowWidth / 2);
+            const auto& transform = entity.GetComponent<TransformComponent>();
+            const glm::vec2 position = glm::mix(transform.previousPosition, transform.position, static_cast<float>(alpha));
+
+            if (position.x + (camera.w / 2) < Game::mapWidth) {
+                camera.x = position.x - (Game::windowWidth / 2);
             }
 
-            if (transform.position.y + (camera.h / 2) < Game::mapHeight) {
-                camera.y = transform.position.y - (Game::windowHeight / 2);
+            if (position.y + (camera.h / 2) < Game::mapHeight) {
+                camera.y = position.y - (Game::windowHeight / 2);
             }
 
             // Keep camera rectangle view inside the screen limits
@@ -2,53 +2,84 @@
 #define COLLISIONSYSTEM_H
 
 #include <SDL.h>
+#include <vector>
+#include <utility>
 
 #include "../ECS/ECS.h"
 #include "../EventBus/EventBus.h"
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/TransformComponent.h"
 #include "../Events/CollisionEvent.h"
+#include "../Memory/FrameAllocator.h"
 
 class CollisionSystem : public System {
 	public:
 		CollisionSystem() {
 			RequireComponent<TransformComponent>();
 			RequireComponent<BoxColliderComponent>();
+			ReadsComponent<TransformComponent>();
+			ReadsComponent<BoxColliderComponent>();
+			RequireExclusiveAccess();
 		}
 
 		void Update(std::unique_ptr<EventBus>& eventBus) {
-			auto entities = GetSystemEntities();
+			FrameVector<Entity> entities;
+			entities.reserve(GetSystemEntities().size());
+			for (const auto& entity : GetSystemEntities()) {
+				if (entity.IsActive()) entities.push_back(entity);
+			}
+			if (entities.empty()) return;
+			const size_t grainSize = 64;
 
-			for (auto i = entities.begin(); i != entities.end(); i++) {
-				Entity a = *i;
-				auto& aTranform = a.GetComponent<TransformComponent>();
-				auto& aCollider = a.GetComponent<BoxColliderComponent>();
+			// The narrow phase runs in parallel, each chunk of `a` entities
+			// collects its own contacts; events are then emitted in the same
+			// order a serial pass would produce
+			FrameVector<FrameVector<std::pair<Entity, Entity>>> collisionsPerChunk((entities.size() + grainSize - 1) / grainSize);
 
-				for (auto j = i; j != entities.end(); j++) {
-					Entity b = *j;
+			auto narrowPhase = [&](size_t begin, size_t end) {
+				auto& collisions = collisionsPerChunk[begin / grainSize];
 
-					if (a == b) continue;
+				for (size_t i = begin; i < end; i++) {
+					const Entity& a = entities[i];
+					const auto& aTranform = a.GetComponent<TransformComponent>();
+					const auto& aCollider = a.GetComponent<BoxColliderComponent>();
 
-					auto& bTranform = b.GetComponent<TransformComponent>();
-					auto& bCollider = b.GetComponent<BoxColliderComponent>();
+					for (size_t j = i + 1; j < entities.size(); j++) {
+						const Entity& b = entities[j];
+						const auto& bTranform = b.GetComponent<TransformComponent>();
+						const auto& bCollider = b.GetComponent<BoxColliderComponent>();
 
-					bool isCollisionHappened = this->CheckAABBCollision(
-						aTranform.position.x + aCollider.offSet.x,
-						aTranform.position.y + aCollider.offSet.y,
-						aCollider.width,
-						aCollider.height,
-						bTranform.position.x + bCollider.offSet.x,
-						bTranform.position.y + bCollider.offSet.y,
-						bCollider.width,
-						bCollider.height
-					);
+						bool isCollisionHappened = this->CheckAABBCollision(
+							aTranform.position.x + aCollider.offSet.x,
+							aTranform.position.y + aCollider.offSet.y,
+							aCollider.width,
+							aCollider.height,
+							bTranform.position.x + bCollider.offSet.x,
+							bTranform.position.y + bCollider.offSet.y,
+							bCollider.width,
+							bCollider.height
+						);
 
-					if (isCollisionHappened) {
-						Logger::Success("Entity " + std::to_string(a.GetId()) + " is coliding with entity " + std::to_string(b.GetId()));
-					
-						eventBus->EmitEvent<CollisionEvent>(a, b);
+						if (isCollisionHappened) {
+							collisions.emplace_back(a, b);
+						}
 					}
 				}
+			};
+
+			if (GetJobSystem()) {
+				GetJobSystem()->ParallelFor(entities.size(), grainSize, narrowPhase);
+			}
+			else {
+				narrowPhase(0, entities.size());
+			}
+
+			for (const auto& collisions : collisionsPerChunk) {
+				for (const auto& collision : collisions) {
+					Logger::Success("Entity " + std::to_string(collision.first.GetId()) + " is coliding with entity " + std::to_string(collision.second.GetId()));
+
+					eventBus->EmitEvent<CollisionEvent>(collision.first, collision.second);
+				}
 			}
 		}
 
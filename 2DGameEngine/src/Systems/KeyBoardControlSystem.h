@@ -24,6 +24,8 @@ class KeyboardControlSystem : public System {
 
 		void OnKeyPressed(KeyPressedEvent& event) {
 			for (auto& entity : GetSystemEntities()) {
+				if (!entity.IsActive()) continue;
+
 				auto& keyboardControl = entity.GetComponent<KeyboardControlComponent>();
 				auto& sprite = entity.GetComponent<SpriteComponent>();
 				auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
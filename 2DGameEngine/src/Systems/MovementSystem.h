@@ -10,16 +10,18 @@ class MovementSystem: public System {
 		MovementSystem() {
 			RequireComponent<TransformComponent>();
 			RequireComponent<RigidBodyComponent>();
+			ReadsComponent<RigidBodyComponent>();
 		}
 
 		void Update(double deltaTime) {
-			for (auto& entity : GetSystemEntities()) {
+			ParallelEach([deltaTime](Entity entity) {
 				auto& transform = entity.GetComponent<TransformComponent>();
 				const auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
 
+				transform.previousPosition = transform.position;
 				transform.position.x += rigidBody.velocity.x * deltaTime;
 				transform.position.y += rigidBody.velocity.y * deltaTime;
-			}
+			}, 1024);
 		}
 };
 
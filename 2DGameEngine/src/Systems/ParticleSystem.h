@@ -0,0 +1,178 @@
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+
+#include <SDL.h>
+#include <cmath>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "../ECS/ECS.h"
+#include "../EventBus/EventBus.h"
+#include "../Events/ProjectileFiredEvent.h"
+#include "../Particles/ParticleBuffer.h"
+#include "../Memory/FrameAllocator.h"
+#include "../Components/TransformComponent.h"
+#include "../Components/ParticleEmitterComponent.h"
+
+// Particles handled by one job when the update is split across workers,
+// a multiple of 4 so only the last range has a scalar tail
+const size_t PARTICLE_GRAIN_SIZE = 8192;
+
+// Emitters are entities, the particles are not: they live in a
+// ParticleBuffer, are integrated with SIMD in parallel ranges and drawn as
+// untextured quads in a single SDL_RenderGeometry call. SDL older than
+// 2.0.18 fills the quads one by one. Spawning uses its own xorshift
+// generator so replays spawn the same particles.
+class ParticleSystem: public System {
+	private:
+		ParticleBuffer m_particles;
+		uint32_t m_randomState = 0x9E3779B9u;
+
+		float NextRandom() {
+			m_randomState ^= m_randomState << 13;
+			m_randomState ^= m_randomState >> 17;
+			m_randomState ^= m_randomState << 5;
+			return (m_randomState >> 8) * (1.0f / 16777216.0f);
+		}
+
+		static Uint8 Mix(Uint8 start, Uint8 end, float t) {
+			return static_cast<Uint8>(start + (end - start) * t);
+		}
+
+	public:
+		ParticleSystem() {
+			RequireComponent<ParticleEmitterComponent>();
+			RequireComponent<TransformComponent>();
+			ReadsComponent<TransformComponent>();
+			WritesComponent<ParticleEmitterComponent>();
+		}
+
+		void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) {
+			eventBus->SubscribeToEvent<ProjectileFiredEvent>(this, &ParticleSystem::OnProjectileFired);
+		}
+
+		// Emitted by the exclusive ProjectileEmitSystem, never during Update
+		void OnProjectileFired(ProjectileFiredEvent& event) {
+			if (!event.emitter.HasComponent<ParticleEmitterComponent>()) return;
+
+			const auto& emitter = event.emitter.GetComponent<ParticleEmitterComponent>();
+			Spawn(emitter, event.position, emitter.burstCount);
+		}
+
+		void Spawn(const ParticleEmitterComponent& emitter, glm::vec2 position, int count) {
+			const float degreesToRadians = 3.14159265f / 180.0f;
+			for (int i = 0; i < count; i++) {
+				const float angle = (emitter.direction + (NextRandom() - 0.5f) * emitter.spread) * degreesToRadians;
+				const float speed = emitter.minSpeed + (emitter.maxSpeed - emitter.minSpeed) * NextRandom();
+				const float lifetime = emitter.particleLifetime * (0.75f + 0.5f * NextRandom());
+				const glm::vec2 velocity(std::cos(angle) * speed, std::sin(angle) * speed);
+
+				if (!m_particles.Add(position + emitter.offset, velocity, lifetime, emitter.particleSize, emitter.startColor, emitter.endColor)) {
+					return;
+				}
+			}
+		}
+
+		void Clear() {
+			m_particles.Clear();
+		}
+
+		size_t GetNumOfParticles() const {
+			return m_particles.GetCount();
+		}
+
+		void Update(double deltaTime) {
+			const float frameDeltaTime = static_cast<float>(deltaTime);
+
+			for (const auto& entity : GetSystemEntities()) {
+				if (!entity.IsActive()) continue;
+
+				auto& emitter = entity.GetComponent<ParticleEmitterComponent>();
+				if (emitter.emissionRate <= 0.0f) continue;
+
+				emitter.emissionAccumulator += frameDeltaTime * emitter.emissionRate;
+				const int count = static_cast<int>(emitter.emissionAccumulator);
+				emitter.emissionAccumulator -= count;
+				Spawn(emitter, entity.GetComponent<TransformComponent>().position, count);
+			}
+
+			if (GetJobSystem()) {
+				GetJobSystem()->ParallelFor(m_particles.GetCount(), PARTICLE_GRAIN_SIZE, [this, frameDeltaTime](size_t begin, size_t end) {
+					m_particles.Integrate(frameDeltaTime, begin, end);
+				});
+			}
+			else {
+				m_particles.Integrate(frameDeltaTime, 0, m_particles.GetCount());
+			}
+			m_particles.RemoveDead();
+		}
+
+		void Render(SDL_Renderer* renderer, const SDL_Rect& camera) {
+			const size_t count = m_particles.GetCount();
+			if (count == 0) return;
+
+			const float* positionX = m_particles.GetPositionX();
+			const float* positionY = m_particles.GetPositionY();
+			const float* age = m_particles.GetAge();
+			const float* lifetime = m_particles.GetLifetime();
+			const float* size = m_particles.GetSize();
+			const SDL_Color* startColor = m_particles.GetStartColor();
+			const SDL_Color* endColor = m_particles.GetEndColor();
+
+			SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+			FrameVector<SDL_Vertex> vertices;
+			FrameVector<int> indices;
+			vertices.reserve(count * 4);
+			indices.reserve(count * 6);
+#endif
+
+			for (size_t i = 0; i < count; i++) {
+				const float halfSize = size[i] * 0.5f;
+				const float x = positionX[i] - camera.x;
+				const float y = positionY[i] - camera.y;
+				if (x + halfSize < 0 || y + halfSize < 0 || x - halfSize > camera.w || y - halfSize > camera.h) continue;
+
+				const float t = age[i] / lifetime[i];
+				const SDL_Color color = {
+					Mix(startColor[i].r, endColor[i].r, t),
+					Mix(startColor[i].g, endColor[i].g, t),
+					Mix(startColor[i].b, endColor[i].b, t),
+					Mix(startColor[i].a, endColor[i].a, t)
+				};
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+				const int firstVertex = static_cast<int>(vertices.size());
+				vertices.push_back({ { x - halfSize, y - halfSize }, color, { 0.0f, 0.0f } });
+				vertices.push_back({ { x + halfSize, y - halfSize }, color, { 0.0f, 0.0f } });
+				vertices.push_back({ { x + halfSize, y + halfSize }, color, { 0.0f, 0.0f } });
+				vertices.push_back({ { x - halfSize, y + halfSize }, color, { 0.0f, 0.0f } });
+
+				indices.push_back(firstVertex);
+				indices.push_back(firstVertex + 1);
+				indices.push_back(firstVertex + 2);
+				indices.push_back(firstVertex);
+				indices.push_back(firstVertex + 2);
+				indices.push_back(firstVertex + 3);
+#else
+				const SDL_Rect rectangle = {
+					static_cast<int>(x - halfSize),
+					static_cast<int>(y - halfSize),
+					static_cast<int>(size[i]),
+					static_cast<int>(size[i])
+				};
+				SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+				SDL_RenderFillRect(renderer, &rectangle);
+#endif
+			}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+			if (!vertices.empty()) {
+				SDL_RenderGeometry(renderer, NULL, vertices.data(), static_cast<int>(vertices.size()), indices.data(), static_cast<int>(indices.size()));
+			}
+#endif
+		}
+};
+
+#endif
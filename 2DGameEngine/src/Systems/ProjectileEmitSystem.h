@@ -2,8 +2,12 @@
 #define PROJECTILEEMITSYSTEM_H
 
 #include <SDL.h>
+#include <map>
 
 #include "../ECS/ECS.h"
+#include "../ECS/Prefab.h"
+#include "../ECS/EntityPool.h"
+#include "../EventBus/EventBus.h"
 
 #include "../Components/TransformComponent.h"
 #include "../Components/ProjectileEmitterComponent.h"
@@ -11,23 +15,92 @@
 #include "../Components/SpriteComponent.h"
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/ProjectileComponent.h"
+#include "../Components/CameraFollowComponent.h"
 
 #include "../Events/KeyPressedEvent.h"
+#include "../Events/ProjectileFiredEvent.h"
 
 class ProjectileEmitSystem : public System {
+private:
+	Prefab m_projectilePrefab;
+	std::map<Entity, EntityPool> m_projectilePoolPerEmitter;
+	// Bus of the current step, set on subscription
+	EventBus* m_eventBus = nullptr;
+
+	void EmitProjectile(Registry& registry, Entity emitter, glm::vec2 position, glm::vec2 velocity, const ProjectileEmitterComponent& projectileEmitter) {
+		m_projectilePrefab.GetComponent<TransformComponent>() = TransformComponent(position, glm::vec2(1.0, 1.0), 0.0);
+		m_projectilePrefab.GetComponent<RigidBodyComponent>() = RigidBodyComponent(velocity);
+		m_projectilePrefab.GetComponent<ProjectileComponent>() = ProjectileComponent(
+			projectileEmitter.isFriendly,
+			projectileEmitter.hitPercentDamage,
+			projectileEmitter.projectileDuration
+		);
+
+		if (projectileEmitter.maxProjectiles <= 0) {
+			registry.Instantiate(m_projectilePrefab);
+			if (m_eventBus) m_eventBus->EmitEvent<ProjectileFiredEvent>(emitter, position);
+			return;
+		}
+
+		m_projectilePrefab.GetComponent<ProjectileComponent>().isPooled = true;
+
+		auto pool = m_projectilePoolPerEmitter.find(emitter);
+		if (pool == m_projectilePoolPerEmitter.end()) {
+			pool = m_projectilePoolPerEmitter.emplace(emitter, EntityPool(projectileEmitter.maxProjectiles)).first;
+		}
+
+		// With every pooled projectile in flight the shot is dropped
+		Entity projectile(0);
+		if (pool->second.Acquire(registry, m_projectilePrefab, projectile) && m_eventBus) {
+			m_eventBus->EmitEvent<ProjectileFiredEvent>(emitter, position);
+		}
+	}
+
+	// Emitter gone: idle projectiles are killed, the ones in flight are no
+	// longer pooled and get killed when they expire
+	void ReleaseOrphanedPools(Registry& registry) {
+		for (auto pool = m_projectilePoolPerEmitter.begin(); pool != m_projectilePoolPerEmitter.end();) {
+			if (registry.IsAlive(pool->first) && HasEntity(pool->first)) {
+				++pool;
+				continue;
+			}
+
+			for (auto projectile : pool->second.Release(registry)) {
+				projectile.GetComponent<ProjectileComponent>().isPooled = false;
+			}
+			pool = m_projectilePoolPerEmitter.erase(pool);
+		}
+	}
+
 public:
 	ProjectileEmitSystem() {
 		RequireComponent<ProjectileEmitterComponent>();
 		RequireComponent<TransformComponent>();
+		ReadsComponent<TransformComponent>();
+		RequireExclusiveAccess();
+
+		m_projectilePrefab.AddComponent<TransformComponent>();
+		m_projectilePrefab.AddComponent<RigidBodyComponent>();
+		m_projectilePrefab.AddComponent<SpriteComponent>("bullet-image", 4, 4, 4);
+		m_projectilePrefab.AddComponent<BoxColliderComponent>(4, 4);
+		m_projectilePrefab.AddComponent<ProjectileComponent>();
 	}
 
+    // After a snapshot load, every pooled handle is dead
+    void ClearProjectilePools() {
+        m_projectilePoolPerEmitter.clear();
+    }
+
     void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) {
+        m_eventBus = eventBus.get();
         eventBus->SubscribeToEvent<KeyPressedEvent>(this, &ProjectileEmitSystem::OnKeyPressed);
     }
 
 	void OnKeyPressed(KeyPressedEvent& event) {
         if (event.symbol == SDLK_SPACE) {
 			for (auto& entity : GetSystemEntities()) {
+                if (!entity.IsActive()) continue;
+
                 if (entity.HasComponent<CameraFollowComponent>()) {
                     const auto projectileEmitter = entity.GetComponent<ProjectileEmitterComponent>();
                     const auto transform = entity.GetComponent<TransformComponent>();
@@ -50,23 +123,18 @@ public:
                     projectileVelocity.x = projectileEmitter.projectileVelocity.x * directionX;
                     projectileVelocity.y = projectileEmitter.projectileVelocity.y * directionY;
 
-                    Entity projectile = entity.registry->CreateEntity();
-                    projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1.0, 1.0), 0.0);
-                    projectile.AddComponent<RigidBodyComponent>(projectileVelocity);
-                    projectile.AddComponent<SpriteComponent>("bullet-image", 4, 4, 4);
-                    projectile.AddComponent<BoxColliderComponent>(4, 4);
-                    projectile.AddComponent<ProjectileComponent>(
-                        projectileEmitter.isFriendly, 
-                        projectileEmitter.hitPercentDamage, 
-                        projectileEmitter.projectileDuration
-                    );
+                    EmitProjectile(*entity.registry, entity, projectilePosition, projectileVelocity, projectileEmitter);
                 }
 			}
         }
 	}
 
-	void Update(std::unique_ptr<Registry>& registry) {
+	void Update(std::unique_ptr<Registry>& registry, double deltaTime) {
+		ReleaseOrphanedPools(*registry);
+
 		for (auto& entity : GetSystemEntities()) {
+            if (!entity.IsActive()) continue;
+
             const auto& transform = entity.GetComponent<TransformComponent>();
 			auto& projectileEmitter = entity.GetComponent<ProjectileEmitterComponent>();
 
@@ -74,7 +142,9 @@ public:
                 continue;
             }
 
-            if (SDL_GetTicks() - projectileEmitter.lastEmissionTime > projectileEmitter.repeatFrequency) {
+            projectileEmitter.timeSinceLastEmission += deltaTime * 1000.0;
+
+            if (projectileEmitter.timeSinceLastEmission > projectileEmitter.repeatFrequency) {
                 glm::vec2 projectilePosition = transform.position;
                 if (entity.HasComponent<SpriteComponent>()) {
                     const auto& sprite = entity.GetComponent<SpriteComponent>();
@@ -82,18 +152,9 @@ public:
                     projectilePosition.y += (transform.scale.y * sprite.height / 2);
                 }
 
-                Entity projectile = registry->CreateEntity();
-                projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1.0, 1.0), 0.0);
-                projectile.AddComponent<RigidBodyComponent>(projectileEmitter.projectileVelocity);
-                projectile.AddComponent<SpriteComponent>("bullet-image", 4, 4, 4);
-                projectile.AddComponent<BoxColliderComponent>(4, 4);
-                projectile.AddComponent<ProjectileComponent>(
-                    projectileEmitter.isFriendly, 
-                    projectileEmitter.hitPercentDamage, 
-                    projectileEmitter.projectileDuration
-                );
-
-                projectileEmitter.lastEmissionTime = SDL_GetTicks();
+                EmitProjectile(*registry, entity, projectilePosition, projectileEmitter.projectileVelocity, projectileEmitter);
+
+                projectileEmitter.timeSinceLastEmission = 0.0;
             }
 		}
 	}
@@ -12,15 +12,39 @@ public:
         RequireComponent<ProjectileComponent>();
     }
 
-    void Update() {
+    // Pooled projectiles restored by a snapshot belong to no pool: idle ones
+    // are killed, the ones in flight get killed when they expire
+    void ReleasePooledProjectiles() {
         for (auto& entity : GetSystemEntities()) {
             auto& projectile = entity.GetComponent<ProjectileComponent>();
+            if (!projectile.isPooled) continue;
 
-            if (SDL_GetTicks() - projectile.startTime > projectile.duration) {
+            if (entity.IsActive()) {
+                projectile.isPooled = false;
+            }
+            else {
                 entity.Kill();
             }
         }
     }
+
+    void Update(double deltaTime) {
+        for (auto& entity : GetSystemEntities()) {
+            if (!entity.IsActive()) continue;
+
+            auto& projectile = entity.GetComponent<ProjectileComponent>();
+            projectile.elapsedTime += deltaTime * 1000.0;
+
+            if (projectile.elapsedTime > projectile.duration) {
+                if (projectile.isPooled) {
+                    entity.SetActive(false);
+                }
+                else {
+                    entity.Kill();
+                }
+            }
+        }
+    }
 };
 
 #endif
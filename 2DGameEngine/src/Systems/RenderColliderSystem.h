@@ -14,14 +14,17 @@ class RenderColliderSystem : public System {
             RequireComponent<BoxColliderComponent>();
         }
 
-        void Update(SDL_Renderer* renderer, SDL_Rect& camera) {
+        void Update(SDL_Renderer* renderer, SDL_Rect& camera, double alpha) {
             for (auto& entity : GetSystemEntities()) {
+                if (!entity.IsActive()) continue;
+
                 const auto& transform = entity.GetComponent<TransformComponent>();
                 const auto& collider = entity.GetComponent<BoxColliderComponent>();
+                const glm::vec2 position = glm::mix(transform.previousPosition, transform.position, static_cast<float>(alpha));
 
                 SDL_Rect colliderRect = {
-                    static_cast<int>(transform.position.x + collider.offSet.x - camera.x),
-                    static_cast<int>(transform.position.y + collider.offSet.y - camera.y),
+                    static_cast<int>(position.x + collider.offSet.x - camera.x),
+                    static_cast<int>(position.y + collider.offSet.y - camera.y),
                     static_cast<int>(collider.width * transform.scale.x),
                     static_cast<int>(collider.height * transform.scale.y)
                 };
@@ -0,0 +1,129 @@
+#ifndef RENDERGUISYSTEM_H
+#define RENDERGUISYSTEM_H
+
+#include <algorithm>
+#include <imgui/imgui.h>
+#include <imgui/imgui_sdl.h>
+
+#include "../ECS/ECS.h"
+#include "../Logger/Logger.h"
+#include "../Profiler/Profiler.h"
+#include "../Memory/FrameAllocator.h"
+
+class RenderGUISystem : public System {
+	public:
+		RenderGUISystem() = default;
+
+		void Update() {
+			ImGui::NewFrame();
+
+			RenderProfilerWindow();
+			RenderLogWindow();
+
+			ImGui::Render();
+			ImGuiSDL::Render(ImGui::GetDrawData());
+		}
+
+	private:
+		void RenderProfilerWindow() {
+			const auto& frameTimes = Profiler::GetFrameTimes();
+			const unsigned int numOfFrames = std::min(Profiler::GetNumOfFrames(), PROFILER_HISTORY_FRAMES);
+
+			float frameTimeTotal = 0.0f;
+			float frameTimeMax = 0.0f;
+			for (unsigned int i = 0; i < numOfFrames; i++) {
+				frameTimeTotal += frameTimes[i];
+				frameTimeMax = std::max(frameTimeMax, frameTimes[i]);
+			}
+			const float frameTimeAverage = numOfFrames > 0 ? frameTimeTotal / numOfFrames : 0.0f;
+
+			ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_Once);
+			ImGui::SetNextWindowSize(ImVec2(520, 400), ImGuiCond_Once);
+			if (ImGui::Begin("Profiler")) {
+				char overlay[64];
+				snprintf(overlay, sizeof(overlay), "avg %.2f ms (%.0f FPS)", frameTimeAverage, frameTimeAverage > 0.0f ? 1000.0f / frameTimeAverage : 0.0f);
+				ImGui::PlotLines(
+					"##frametimes",
+					frameTimes.data(),
+					PROFILER_HISTORY_FRAMES,
+					Profiler::GetHistoryOffset(),
+					overlay,
+					0.0f,
+					std::max(frameTimeMax, 1000.0f / 30.0f),
+					ImVec2(ImGui::GetContentRegionAvail().x, 80)
+				);
+
+				ImGui::Text(
+					"Frame allocator: %zu KB last frame, %zu KB peak, %zu KB capacity",
+					FrameAllocator::GetLastFrameBytes() / 1024,
+					FrameAllocator::GetPeakFrameBytes() / 1024,
+					FrameAllocator::GetCapacity() / 1024
+				);
+
+				ImGui::Columns(5, "zones");
+				ImGui::SetColumnWidth(0, 220);
+				ImGui::Text("Zone"); ImGui::NextColumn();
+				ImGui::Text("ms"); ImGui::NextColumn();
+				ImGui::Text("min"); ImGui::NextColumn();
+				ImGui::Text("avg"); ImGui::NextColumn();
+				ImGui::Text("max"); ImGui::NextColumn();
+				ImGui::Separator();
+
+				for (const auto& zone : Profiler::GetZones()) {
+					ImGui::Indent(zone.depth * 10.0f + 1.0f);
+					ImGui::TextUnformatted(zone.name.c_str());
+					ImGui::Unindent(zone.depth * 10.0f + 1.0f);
+					ImGui::NextColumn();
+					ImGui::Text("%.3f", zone.GetLast()); ImGui::NextColumn();
+					ImGui::Text("%.3f", zone.GetMin()); ImGui::NextColumn();
+					ImGui::Text("%.3f", zone.GetAverage()); ImGui::NextColumn();
+					ImGui::Text("%.3f", zone.GetMax()); ImGui::NextColumn();
+				}
+				ImGui::Columns(1);
+			}
+			ImGui::End();
+		}
+
+		void RenderLogWindow() {
+			static int selectedType = LOG_TYPE_COUNT;
+			static const char* typeNames[] = { "Info", "Warning", "Success", "Error", "Log", "All" };
+			static const ImVec4 typeColors[] = {
+				ImVec4(0.4f, 0.6f, 1.0f, 1.0f),
+				ImVec4(1.0f, 0.8f, 0.2f, 1.0f),
+				ImVec4(0.3f, 0.9f, 0.3f, 1.0f),
+				ImVec4(1.0f, 0.3f, 0.3f, 1.0f),
+				ImVec4(0.9f, 0.9f, 0.9f, 1.0f)
+			};
+
+			ImGui::SetNextWindowPos(ImVec2(10, 420), ImGuiCond_Once);
+			ImGui::SetNextWindowSize(ImVec2(520, 260), ImGuiCond_Once);
+			if (ImGui::Begin("Log")) {
+				ImGui::Combo("Level", &selectedType, typeNames, IM_ARRAYSIZE(typeNames));
+				ImGui::BeginChild("entries");
+
+				auto renderEntry = [](const LogEntry& entry) {
+					ImGui::PushStyleColor(ImGuiCol_Text, typeColors[entry.type]);
+					ImGui::TextUnformatted(entry.Begin(), entry.End());
+					ImGui::PopStyleColor();
+				};
+
+				if (selectedType == LOG_TYPE_COUNT) {
+					ImGuiListClipper clipper;
+					clipper.Begin(Logger::messages.GetSize());
+					while (clipper.Step()) {
+						for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+							renderEntry(Logger::messages[i]);
+						}
+					}
+				}
+				else {
+					Logger::messages.ForEachOfType(static_cast<LogType>(selectedType), renderEntry);
+				}
+
+				ImGui::EndChild();
+			}
+			ImGui::End();
+		}
+};
+
+#endif
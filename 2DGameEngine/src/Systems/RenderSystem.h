@@ -8,6 +8,7 @@
 #include "../Components/TransformComponent.h"
 #include "../Components/SpriteComponent.h"
 #include "../AssetManager/AssetManager.h"
+#include "../Memory/FrameAllocator.h"
 
 class RenderSystem : public System {
 	public:
@@ -16,15 +17,18 @@ class RenderSystem : public System {
 			RequireComponent<SpriteComponent>();
 		}
 
-		void Update(SDL_Renderer* renderer, std::unique_ptr<AssetManager>& assetManager, SDL_Rect& camera) {
+		void Update(SDL_Renderer* renderer, std::unique_ptr<AssetManager>& assetManager, SDL_Rect& camera, double alpha) {
 			struct RenderableEntity {
 				TransformComponent transformComponent;
 				SpriteComponent spriteComponent;
 			};
 
-			std::vector<RenderableEntity> renderableEntities;
+			FrameVector<RenderableEntity> renderableEntities;
+			renderableEntities.reserve(GetSystemEntities().size());
 
 			for (auto& entity : GetSystemEntities()) {
+				if (!entity.IsActive()) continue;
+
 				RenderableEntity renderableEntity;
 				renderableEntity.spriteComponent = entity.GetComponent<SpriteComponent>();
 				renderableEntity.transformComponent = entity.GetComponent<TransformComponent>();
@@ -40,10 +44,11 @@ class RenderSystem : public System {
 				const auto& sprite = entity.spriteComponent;
 
 				SDL_Rect sourceRectangle = sprite.srcRect;
+				const glm::vec2 position = glm::mix(transform.previousPosition, transform.position, static_cast<float>(alpha));
 
 				SDL_Rect destinationRectangle = {
-					static_cast<int>(transform.position.x - (sprite.isFixed ? 0 : camera.x)),
-					static_cast<int>(transform.position.y - (sprite.isFixed ? 0 : camera.y)),
+					static_cast<int>(position.x - (sprite.isFixed ? 0 : camera.x)),
+					static_cast<int>(position.y - (sprite.isFixed ? 0 : camera.y)),
 					static_cast<int>(sprite.width * transform.scale.x),
 					static_cast<int>(sprite.height * transform.scale.y)
 				};
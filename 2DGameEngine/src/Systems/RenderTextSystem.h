@@ -0,0 +1,140 @@
+#ifndef RENDERTEXTSYSTEM_H
+#define RENDERTEXTSYSTEM_H
+
+#include <SDL.h>
+#include <algorithm>
+
+#include "../ECS/ECS.h"
+#include "../Components/TextLabelComponent.h"
+#include "../AssetManager/AssetManager.h"
+#include "../Memory/FrameAllocator.h"
+
+// Draws text labels as quads sampling their font's glyph atlas, one batched
+// draw per font instead of a texture per string. SDL older than 2.0.18 has
+// no SDL_RenderGeometry and copies the quads one by one from the same atlas.
+class RenderTextSystem: public System {
+	private:
+		struct GlyphQuad {
+			SDL_Rect srcRect;
+			SDL_FRect destinationRect;
+			SDL_Color color;
+		};
+
+		static void DrawQuads(SDL_Renderer* renderer, const FontAtlas& atlas, const FrameVector<GlyphQuad>& quads) {
+			if (quads.empty()) return;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+			FrameVector<SDL_Vertex> vertices;
+			FrameVector<int> indices;
+			vertices.reserve(quads.size() * 4);
+			indices.reserve(quads.size() * 6);
+
+			const float inverseWidth = 1.0f / atlas.width;
+			const float inverseHeight = 1.0f / atlas.height;
+			for (const auto& quad : quads) {
+				const float left = quad.destinationRect.x;
+				const float top = quad.destinationRect.y;
+				const float right = left + quad.destinationRect.w;
+				const float bottom = top + quad.destinationRect.h;
+				const float u0 = quad.srcRect.x * inverseWidth;
+				const float v0 = quad.srcRect.y * inverseHeight;
+				const float u1 = (quad.srcRect.x + quad.srcRect.w) * inverseWidth;
+				const float v1 = (quad.srcRect.y + quad.srcRect.h) * inverseHeight;
+
+				const int firstVertex = static_cast<int>(vertices.size());
+				vertices.push_back({ { left, top }, quad.color, { u0, v0 } });
+				vertices.push_back({ { right, top }, quad.color, { u1, v0 } });
+				vertices.push_back({ { right, bottom }, quad.color, { u1, v1 } });
+				vertices.push_back({ { left, bottom }, quad.color, { u0, v1 } });
+
+				indices.push_back(firstVertex);
+				indices.push_back(firstVertex + 1);
+				indices.push_back(firstVertex + 2);
+				indices.push_back(firstVertex);
+				indices.push_back(firstVertex + 2);
+				indices.push_back(firstVertex + 3);
+			}
+
+			SDL_RenderGeometry(renderer, atlas.texture, vertices.data(), static_cast<int>(vertices.size()), indices.data(), static_cast<int>(indices.size()));
+#else
+			for (const auto& quad : quads) {
+				const SDL_Rect destinationRectangle = {
+					static_cast<int>(quad.destinationRect.x),
+					static_cast<int>(quad.destinationRect.y),
+					static_cast<int>(quad.destinationRect.w),
+					static_cast<int>(quad.destinationRect.h)
+				};
+				SDL_SetTextureColorMod(atlas.texture, quad.color.r, quad.color.g, quad.color.b);
+				SDL_SetTextureAlphaMod(atlas.texture, quad.color.a);
+				SDL_RenderCopy(renderer, atlas.texture, &quad.srcRect, &destinationRectangle);
+			}
+#endif
+		}
+
+	public:
+		RenderTextSystem() {
+			RequireComponent<TextLabelComponent>();
+			ReadsComponent<TextLabelComponent>();
+		}
+
+		void Update(SDL_Renderer* renderer, std::unique_ptr<AssetManager>& assetManager, const SDL_Rect& camera) {
+			struct RenderableLabel {
+				const FontAtlas* atlas;
+				const TextLabelComponent* label;
+			};
+
+			FrameVector<RenderableLabel> renderableLabels;
+			renderableLabels.reserve(GetSystemEntities().size());
+			for (const auto& entity : GetSystemEntities()) {
+				if (!entity.IsActive()) continue;
+
+				const auto& label = entity.GetComponent<TextLabelComponent>();
+				const FontAtlas* atlas = assetManager->GetFontAtlas(label.assetId);
+				if (atlas && atlas->texture) {
+					renderableLabels.push_back({ atlas, &label });
+				}
+			}
+
+			// Labels sharing a font end up next to each other and in one draw
+			std::sort(renderableLabels.begin(), renderableLabels.end(), [](const RenderableLabel& a, const RenderableLabel& b) {
+				return a.atlas < b.atlas;
+			});
+
+			FrameVector<GlyphQuad> quads;
+			const FontAtlas* batchAtlas = nullptr;
+			for (const auto& renderableLabel : renderableLabels) {
+				if (renderableLabel.atlas != batchAtlas) {
+					if (batchAtlas) DrawQuads(renderer, *batchAtlas, quads);
+					quads.clear();
+					batchAtlas = renderableLabel.atlas;
+				}
+
+				const auto& label = *renderableLabel.label;
+				const float originX = label.position.x - (label.isFixed ? 0 : camera.x);
+				float penX = originX;
+				float penY = label.position.y - (label.isFixed ? 0 : camera.y);
+				for (const char character : label.text) {
+					if (character == '\n') {
+						penX = originX;
+						penY += batchAtlas->lineSkip;
+						continue;
+					}
+
+					const Glyph* glyph = batchAtlas->GetGlyph(character);
+					if (!glyph) continue;
+
+					if (glyph->srcRect.w > 0) {
+						quads.push_back({
+							glyph->srcRect,
+							{ penX, penY, static_cast<float>(glyph->srcRect.w), static_cast<float>(glyph->srcRect.h) },
+							label.color
+						});
+					}
+					penX += glyph->advance;
+				}
+			}
+			if (batchAtlas) DrawQuads(renderer, *batchAtlas, quads);
+		}
+};
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef SCRIPTSYSTEM_H
+#define SCRIPTSYSTEM_H
+
+#include <string>
+#include <tuple>
+#include <vector>
+#include <sol/sol.hpp>
+
+#include "../ECS/ECS.h"
+#include "../Logger/Logger.h"
+#include "../Components/ScriptComponent.h"
+#include "../Components/TransformComponent.h"
+#include "../Components/RigidBodyComponent.h"
+
+// Runs Lua update functions in batches: each frame every script is called
+// once as update(entityIds, count, deltaTime) with the ids of all the
+// entities using it, instead of once per entity. Scripts reach components
+// through the accessors bound in BindAccessors.
+class ScriptSystem: public System {
+	private:
+		struct Script {
+			std::string name;
+			sol::protected_function update;
+			// Reused every frame, entries past the current count are stale
+			sol::table entityIds;
+			std::vector<int> batch;
+		};
+
+		std::vector<Script> m_scripts;
+
+		// Ids come from scripts, a bad one raises a Lua error in the calling
+		// script instead of reaching an unchecked pool index
+		template <typename TComponent>
+		static TComponent& GetScriptedComponent(Registry& registry, int entityId, const char* function, const char* componentName) {
+			if (entityId < 0 || entityId >= registry.GetNumOfEntities()) {
+				throw sol::error(std::string(function) + ": unknown entity id " + std::to_string(entityId));
+			}
+
+			// A free id has an empty signature, so it fails the component check
+			const Entity entity = registry.GetEntity(entityId);
+			if (!registry.IsAlive(entity) || !registry.HasComponent<TComponent>(entity)) {
+				throw sol::error(std::string(function) + ": entity " + std::to_string(entityId) + " has no " + componentName + " component");
+			}
+			return registry.GetComponent<TComponent>(entity);
+		}
+
+	public:
+		ScriptSystem() {
+			RequireComponent<ScriptComponent>();
+			ReadsComponent<ScriptComponent>();
+			// Written through the Lua accessors
+			WritesComponent<TransformComponent>();
+			WritesComponent<RigidBodyComponent>();
+		}
+
+		// Exposes get/set_position and get/set_velocity by entity id
+		void BindAccessors(sol::state& lua, const std::unique_ptr<Registry>& registry) {
+			Registry* registryPtr = registry.get();
+
+			lua.set_function("get_position", [registryPtr](int entityId) {
+				const auto& transform = GetScriptedComponent<TransformComponent>(*registryPtr, entityId, "get_position", "transform");
+				return std::make_tuple(transform.position.x, transform.position.y);
+			});
+			lua.set_function("set_position", [registryPtr](int entityId, double x, double y) {
+				auto& transform = GetScriptedComponent<TransformComponent>(*registryPtr, entityId, "set_position", "transform");
+				transform.position.x = x;
+				transform.position.y = y;
+			});
+			lua.set_function("get_velocity", [registryPtr](int entityId) {
+				const auto& rigidBody = GetScriptedComponent<RigidBodyComponent>(*registryPtr, entityId, "get_velocity", "rigidbody");
+				return std::make_tuple(rigidBody.velocity.x, rigidBody.velocity.y);
+			});
+			lua.set_function("set_velocity", [registryPtr](int entityId, double x, double y) {
+				auto& rigidBody = GetScriptedComponent<RigidBodyComponent>(*registryPtr, entityId, "set_velocity", "rigidbody");
+				rigidBody.velocity.x = x;
+				rigidBody.velocity.y = y;
+			});
+		}
+
+		// Returns the id to store in ScriptComponent, re-adding a name replaces
+		// its function
+		int AddScript(sol::state& lua, const std::string& name, sol::protected_function update) {
+			const int scriptId = GetScriptId(name);
+			if (scriptId >= 0) {
+				m_scripts[scriptId].update = update;
+				return scriptId;
+			}
+
+			m_scripts.push_back({ name, update, lua.create_table(), {} });
+			return static_cast<int>(m_scripts.size()) - 1;
+		}
+
+		int GetScriptId(const std::string& name) const {
+			for (size_t i = 0; i < m_scripts.size(); i++) {
+				if (m_scripts[i].name == name) {
+					return static_cast<int>(i);
+				}
+			}
+			return -1;
+		}
+
+		void ClearScripts() {
+			m_scripts.clear();
+		}
+
+		void Update(double deltaTime) {
+			for (auto& script : m_scripts) {
+				script.batch.clear();
+			}
+
+			for (const auto& entity : GetSystemEntities()) {
+				if (!entity.IsActive()) continue;
+
+				const int scriptId = entity.GetComponent<ScriptComponent>().scriptId;
+				if (scriptId >= 0 && scriptId < static_cast<int>(m_scripts.size())) {
+					m_scripts[scriptId].batch.push_back(entity.GetId());
+				}
+			}
+
+			for (auto& script : m_scripts) {
+				if (script.batch.empty()) continue;
+
+				const int count = static_cast<int>(script.batch.size());
+				for (int i = 0; i < count; i++) {
+					script.entityIds.raw_set(i + 1, script.batch[i]);
+				}
+
+				sol::protected_function_result result = script.update(script.entityIds, count, deltaTime);
+				if (!result.valid()) {
+					sol::error error = result;
+					Logger::Error("Script '" + script.name + "' failed: " + error.what());
+				}
+			}
+		}
+};
+
+#endif
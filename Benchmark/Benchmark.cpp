@@ -0,0 +1,276 @@
+// ECS stress benchmark. Builds scenes of increasing size with the game's
+// components and times entity creation/destruction, prefab instantiation,
+// snapshot save/load, the registry update, each system update, collision
+// pair throughput, event dispatch and the particle update and render.
+//
+// usage: Benchmark [entityCount...]   (default: 1000 10000 100000)
+//
+// Results are printed to stdout as CSV, one line per measurement. The
+// *_threads_N lines repeat the parallel systems on a job system with N
+// threads (N - 1 workers plus the main thread) to measure scaling.
+// Build with ECS_ARCHETYPE_STORAGE defined to compare the storage backends.
+
+#include <SDL.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../2DGameEngine/src/ECS/ECS.h"
+#include "../2DGameEngine/src/ECS/Prefab.h"
+#include "../2DGameEngine/src/EventBus/EventBus.h"
+#include "../2DGameEngine/src/AssetManager/AssetManager.h"
+#include "../2DGameEngine/src/Logger/Logger.h"
+#include "../2DGameEngine/src/Jobs/JobSystem.h"
+#include "../2DGameEngine/src/Memory/FrameAllocator.h"
+
+#include "../2DGameEngine/src/Components/TransformComponent.h"
+#include "../2DGameEngine/src/Components/RigidBodyComponent.h"
+#include "../2DGameEngine/src/Components/SpriteComponent.h"
+#include "../2DGameEngine/src/Components/AnimationComponent.h"
+#include "../2DGameEngine/src/Components/BoxColliderComponent.h"
+#include "../2DGameEngine/src/Components/CameraFollowComponent.h"
+#include "../2DGameEngine/src/Components/HealthComponent.h"
+#include "../2DGameEngine/src/Components/ProjectileComponent.h"
+#include "../2DGameEngine/src/Components/ProjectileEmitterComponent.h"
+#include "../2DGameEngine/src/Components/ParticleEmitterComponent.h"
+
+#include "../2DGameEngine/src/Systems/MovementSystem.h"
+#include "../2DGameEngine/src/Systems/RenderSystem.h"
+#include "../2DGameEngine/src/Systems/AnimationSystem.h"
+#include "../2DGameEngine/src/Systems/CollisionSystem.h"
+#include "../2DGameEngine/src/Systems/RenderColliderSystem.h"
+#include "../2DGameEngine/src/Systems/DamageSystem.h"
+#include "../2DGameEngine/src/Systems/KeyBoardControlSystem.h"
+#include "../2DGameEngine/src/Systems/ProjectileEmitSystem.h"
+#include "../2DGameEngine/src/Systems/ProjectileLifeCycleSystem.h"
+#include "../2DGameEngine/src/Systems/ParticleSystem.h"
+
+// Collision is a brute force O(n^2) pass, larger scenes would take minutes
+const int MAX_COLLISION_ENTITIES = 10000;
+const int SYSTEM_ITERATIONS = 10;
+const int MAP_WIDTH = 2400;
+const int MAP_HEIGHT = 1920;
+const unsigned int SCALING_THREAD_COUNTS[] = { 1, 2, 4, 8, 16 };
+
+typedef std::chrono::high_resolution_clock Clock;
+
+void PrintResult(const std::string& name, int entities, int iterations, double totalMilliseconds, double itemsPerIteration) {
+    const double averageMilliseconds = totalMilliseconds / iterations;
+    const double nanosecondsPerItem = itemsPerIteration > 0 ? averageMilliseconds * 1000000.0 / itemsPerIteration : 0.0;
+    const double itemsPerSecond = averageMilliseconds > 0 ? itemsPerIteration * 1000.0 / averageMilliseconds : 0.0;
+
+    std::printf("%s,%d,%d,%.4f,%.4f,%.2f,%.0f\n", name.c_str(), entities, iterations, totalMilliseconds, averageMilliseconds, nanosecondsPerItem, itemsPerSecond);
+    std::fflush(stdout);
+}
+
+double Measure(int iterations, const std::function<void()>& function) {
+    const auto startTime = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        function();
+        FrameAllocator::Reset();
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+}
+
+void CreateScene(std::unique_ptr<Registry>& registry, int numOfEntities) {
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> positionX(0.0f, MAP_WIDTH);
+    std::uniform_real_distribution<float> positionY(0.0f, MAP_HEIGHT);
+    std::uniform_real_distribution<float> velocity(-100.0f, 100.0f);
+
+    for (int i = 0; i < numOfEntities; i++) {
+        Entity entity = registry->CreateEntity();
+        entity.AddComponent<TransformComponent>(glm::vec2(positionX(random), positionY(random)), glm::vec2(1.0, 1.0), 0.0);
+        entity.AddComponent<RigidBodyComponent>(glm::vec2(velocity(random), velocity(random)));
+        entity.AddComponent<SpriteComponent>("bullet-image", 4, 4, i % 4);
+        entity.AddComponent<BoxColliderComponent>(4, 4);
+
+        if (i % 4 == 0) {
+            entity.AddComponent<ProjectileComponent>(false, 10, 1000000);
+        }
+        if (i % 8 == 0) {
+            entity.AddComponent<AnimationComponent>(AnimationClips::AddUniformClip(2, 12, ANIMATION_LOOP));
+        }
+        if (i % 100 == 0) {
+            entity.AddComponent<HealthComponent>(100);
+            entity.AddComponent<ProjectileEmitterComponent>(glm::vec2(100.0, 0.0), 1, 1000000, 10, false);
+        }
+    }
+}
+
+void RunScene(int numOfEntities, SDL_Renderer* renderer) {
+    auto registry = std::make_unique<Registry>();
+    auto eventBus = std::make_unique<EventBus>();
+    auto assetManager = std::make_unique<AssetManager>();
+    SDL_Rect camera = { 0, 0, MAP_WIDTH, MAP_HEIGHT };
+
+    registry->AddSystem<MovementSystem>();
+    registry->AddSystem<RenderSystem>();
+    registry->AddSystem<AnimationSystem>();
+    registry->AddSystem<CollisionSystem>();
+    registry->AddSystem<RenderColliderSystem>();
+    registry->AddSystem<DamageSystem>();
+    registry->AddSystem<KeyboardControlSystem>();
+    registry->AddSystem<ProjectileEmitSystem>();
+    registry->AddSystem<ProjectileLifeCycleSystem>();
+    registry->AddSystem<ParticleSystem>();
+
+    double milliseconds = Measure(1, [&]() { CreateScene(registry, numOfEntities); });
+    PrintResult("entity_create", numOfEntities, 1, milliseconds, numOfEntities);
+
+    milliseconds = Measure(1, [&]() { registry->Update(); });
+    PrintResult("registry_update_add", numOfEntities, 1, milliseconds, numOfEntities);
+
+    milliseconds = Measure(SYSTEM_ITERATIONS, [&]() { registry->Update(); });
+    PrintResult("registry_update_idle", numOfEntities, SYSTEM_ITERATIONS, milliseconds, numOfEntities);
+
+    milliseconds = Measure(SYSTEM_ITERATIONS, [&]() { registry->GetSystem<MovementSystem>().Update(1.0 / 60.0); });
+    PrintResult("movement_system", numOfEntities, SYSTEM_ITERATIONS, milliseconds, numOfEntities);
+
+    milliseconds = Measure(SYSTEM_ITERATIONS, [&]() {
+        registry->Query<TransformComponent, RigidBodyComponent>([](Entity, TransformComponent& transform, RigidBodyComponent& rigidBody) {
+            transform.position += rigidBody.velocity * static_cast<float>(1.0 / 60.0);
+        });
+    });
+    PrintResult("query_transform_rigidbody", numOfEntities, SYSTEM_ITERATIONS, milliseconds, numOfEntities);
+
+    milliseconds = Measure(SYSTEM_ITERATIONS, [&]() { registry->GetSystem<AnimationSystem>().Update(1.0 / 60.0, eventBus); });
+    PrintResult("animation_system", numOfEntities, SYSTEM_ITERATIONS, milliseconds, numOfEntities / 8);
+
+    milliseconds = Measure(SYSTEM_ITERATIONS, [&]() { registry->GetSystem<ProjectileLifeCycleSystem>().Update(1.0 / 60.0); });
+    PrintResult("projectile_lifecycle_system", numOfEntities, SYSTEM_ITERATIONS, milliseconds, numOfEntities / 4);
+
+    milliseconds = Measure(SYSTEM_ITERATIONS, [&]() { registry->GetSystem<RenderSystem>().Update(renderer, assetManager, camera, 1.0); });
+    PrintResult("render_system", numOfEntities, SYSTEM_ITERATIONS, milliseconds, numOfEntities);
+
+    milliseconds = Measure(SYSTEM_ITERATIONS, [&]() { registry->GetSystem<RenderColliderSystem>().Update(renderer, camera, 1.0); });
+    PrintResult("render_collider_system", numOfEntities, SYSTEM_ITERATIONS, milliseconds, numOfEntities);
+
+    // One particle per entity up to the buffer capacity, living past the run
+    const int numOfParticles = std::min(numOfEntities, static_cast<int>(MAX_PARTICLES));
+    ParticleEmitterComponent particleEmitter(0.0f, 0, 1000000.0f, 10.0f, 100.0f);
+    registry->GetSystem<ParticleSystem>().Spawn(particleEmitter, glm::vec2(MAP_WIDTH / 2, MAP_HEIGHT / 2), numOfParticles);
+
+    milliseconds = Measure(SYSTEM_ITERATIONS, [&]() { registry->GetSystem<ParticleSystem>().Update(1.0 / 60.0); });
+    PrintResult("particle_system", numOfParticles, SYSTEM_ITERATIONS, milliseconds, numOfParticles);
+
+    milliseconds = Measure(SYSTEM_ITERATIONS, [&]() { registry->GetSystem<ParticleSystem>().Render(renderer, camera); });
+    PrintResult("particle_render", numOfParticles, SYSTEM_ITERATIONS, milliseconds, numOfParticles);
+
+    if (numOfEntities <= MAX_COLLISION_ENTITIES) {
+        eventBus->Reset();
+        registry->GetSystem<DamageSystem>().SubscribeToEvents(eventBus);
+        const double numOfPairs = static_cast<double>(numOfEntities) * (numOfEntities - 1) / 2.0;
+
+        milliseconds = Measure(1, [&]() { registry->GetSystem<CollisionSystem>().Update(eventBus); });
+        PrintResult("collision_pairs", numOfEntities, 1, milliseconds, numOfPairs);
+    }
+
+    for (unsigned int numOfThreads : SCALING_THREAD_COUNTS) {
+        JobSystem jobSystem(numOfThreads - 1);
+        registry->SetJobSystem(&jobSystem);
+        const std::string suffix = "_threads_" + std::to_string(numOfThreads);
+
+        milliseconds = Measure(SYSTEM_ITERATIONS, [&]() { registry->GetSystem<MovementSystem>().Update(1.0 / 60.0); });
+        PrintResult("movement_system" + suffix, numOfEntities, SYSTEM_ITERATIONS, milliseconds, numOfEntities);
+
+        milliseconds = Measure(SYSTEM_ITERATIONS, [&]() { registry->GetSystem<ParticleSystem>().Update(1.0 / 60.0); });
+        PrintResult("particle_system" + suffix, numOfParticles, SYSTEM_ITERATIONS, milliseconds, numOfParticles);
+
+        if (numOfEntities <= MAX_COLLISION_ENTITIES) {
+            const double numOfPairs = static_cast<double>(numOfEntities) * (numOfEntities - 1) / 2.0;
+
+            milliseconds = Measure(1, [&]() { registry->GetSystem<CollisionSystem>().Update(eventBus); });
+            PrintResult("collision_pairs" + suffix, numOfEntities, 1, milliseconds, numOfPairs);
+        }
+
+        registry->SetJobSystem(nullptr);
+    }
+
+    eventBus->Reset();
+    registry->GetSystem<DamageSystem>().SubscribeToEvents(eventBus);
+    registry->GetSystem<KeyboardControlSystem>().SubscribeToEvents(eventBus);
+    registry->GetSystem<ProjectileEmitSystem>().SubscribeToEvents(eventBus);
+
+    Entity entityA = registry->GetSystem<CollisionSystem>().GetSystemEntities().front();
+    Entity entityB = registry->GetSystem<CollisionSystem>().GetSystemEntities().back();
+    milliseconds = Measure(1, [&]() {
+        for (int i = 0; i < numOfEntities; i++) {
+            eventBus->EmitEvent<CollisionEvent>(entityA, entityB);
+        }
+    });
+    PrintResult("event_dispatch", numOfEntities, 1, milliseconds, numOfEntities);
+
+    milliseconds = Measure(1, [&]() { registry->GetSystem<ProjectileEmitSystem>().Update(registry, 1.0 / 60.0); });
+    PrintResult("projectile_emit_system", numOfEntities, 1, milliseconds, numOfEntities / 100);
+    registry->Update();
+
+    milliseconds = Measure(1, [&]() {
+        for (auto entity : registry->GetSystem<MovementSystem>().GetSystemEntities()) {
+            entity.Kill();
+        }
+        registry->Update();
+    });
+    PrintResult("entity_destroy", numOfEntities, 1, milliseconds, numOfEntities);
+
+    Prefab prefab;
+    prefab.AddComponent<TransformComponent>();
+    prefab.AddComponent<RigidBodyComponent>(glm::vec2(50.0, 50.0));
+    prefab.AddComponent<SpriteComponent>("bullet-image", 4, 4, 4);
+    prefab.AddComponent<BoxColliderComponent>(4, 4);
+    milliseconds = Measure(1, [&]() { registry->Instantiate(prefab, numOfEntities); });
+    PrintResult("prefab_instantiate", numOfEntities, 1, milliseconds, numOfEntities);
+    registry->Update();
+
+    std::string snapshot;
+    milliseconds = Measure(1, [&]() {
+        std::ostringstream stream(std::ios::binary);
+        registry->SaveSnapshot(stream);
+        snapshot = stream.str();
+    });
+    PrintResult("snapshot_save", numOfEntities, 1, milliseconds, numOfEntities);
+
+    milliseconds = Measure(1, [&]() {
+        std::istringstream stream(snapshot, std::ios::binary);
+        registry->LoadSnapshot(stream);
+        registry->Update();
+    });
+    PrintResult("snapshot_load", numOfEntities, 1, milliseconds, numOfEntities);
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sceneSizes;
+    for (int i = 1; i < argc; i++) {
+        sceneSizes.push_back(std::atoi(argv[i]));
+    }
+    if (sceneSizes.empty()) {
+        sceneSizes = { 1000, 10000, 100000 };
+    }
+
+    // Console logging per entity/component would dominate every measurement
+    Logger::SetEnabled(false);
+
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS);
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(surface);
+
+    std::printf("benchmark,entities,iterations,total_ms,avg_ms,ns_per_item,items_per_second\n");
+    for (int numOfEntities : sceneSizes) {
+        if (numOfEntities > 0) {
+            RunScene(numOfEntities, renderer);
+        }
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    SDL_Quit();
+    return 0;
+}
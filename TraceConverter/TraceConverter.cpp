@@ -0,0 +1,105 @@
+// Converts a binary trace recorded with `2DGameEngine --trace <file>` into
+// Chrome trace event JSON, loadable in chrome://tracing or ui.perfetto.dev.
+//
+// usage: TraceConverter <input.trace> <output.json>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../2DGameEngine/src/Logger/TraceFormat.h"
+
+std::string EscapeJson(const std::string& text) {
+    std::string output;
+    for (char ch : text) {
+        if (ch == '"' || ch == '\\') output += '\\';
+        output += ch;
+    }
+    return output;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: TraceConverter <input.trace> <output.json>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input.is_open()) {
+        std::cerr << "Failed to open trace file: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    TraceFileHeader header;
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!input || header.magic != TRACE_MAGIC || header.version != TRACE_VERSION) {
+        std::cerr << "Not a 2DGameEngine trace file (or unsupported version): " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::ofstream output(argv[2]);
+    if (!output.is_open()) {
+        std::cerr << "Failed to open output file: " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> categories;
+    size_t numOfEvents = 0;
+
+    output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    TraceRecord record;
+    while (input.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (record.kind == TRACE_CATEGORY) {
+            // Where the next record starts is unknown past a bad name, so
+            // the conversion stops there
+            if (record.payload > TRACE_MAX_CATEGORY_NAME_SIZE) {
+                std::cerr << "Corrupt category record (name of " << record.payload << " bytes) in " << argv[1] << std::endl;
+                return 1;
+            }
+
+            std::string name(record.payload, '\0');
+            if (!input.read(&name[0], name.size())) {
+                std::cerr << "Truncated category record in " << argv[1] << std::endl;
+                return 1;
+            }
+            input.ignore((8 - name.size() % 8) % 8);
+
+            if (record.categoryId >= categories.size()) {
+                categories.resize(record.categoryId + 1);
+            }
+            categories[record.categoryId] = name;
+            continue;
+        }
+
+        std::string name = record.categoryId < categories.size() && !categories[record.categoryId].empty()
+            ? categories[record.categoryId]
+            : "category-" + std::to_string(record.categoryId);
+
+        const char* phase = "i";
+        switch (record.kind) {
+            case TRACE_BEGIN: phase = "B"; break;
+            case TRACE_END: phase = "E"; break;
+            case TRACE_COUNTER: phase = "C"; break;
+        }
+
+        // Chrome trace timestamps are microseconds
+        output << (numOfEvents++ ? "," : "") << "\n"
+            << "{\"name\":\"" << EscapeJson(name) << "\""
+            << ",\"cat\":\"engine\""
+            << ",\"ph\":\"" << phase << "\""
+            << ",\"ts\":" << record.timestamp / 1000 << "." << record.timestamp % 1000 / 100 << record.timestamp % 100 / 10 << record.timestamp % 10
+            << ",\"pid\":1"
+            << ",\"tid\":" << record.threadId;
+        if (record.kind == TRACE_INSTANT) {
+            output << ",\"s\":\"t\"";
+        }
+        output << ",\"args\":{\"" << (record.kind == TRACE_COUNTER ? EscapeJson(name) : "payload") << "\":" << record.payload << "}}";
+    }
+
+    output << "\n]}\n";
+
+    std::cout << "Converted " << numOfEvents << " events from " << argv[1] << " to " << argv[2] << std::endl;
+    return 0;
+}